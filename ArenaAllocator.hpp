@@ -0,0 +1,234 @@
+#ifndef _ARENA_ALLOCATOR_H
+#define _ARENA_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include "PolynomialStorage.hpp"
+
+// Memory for whole computations, released in one go.
+//
+// One run of the Euclidean algorithm allocates and frees buffers (and map nodes of sparse polynomials) at every
+// step. An arena takes large blocks from the heap and hands out pieces of them; freed pieces are kept in lists
+// by their (power of two) size, and reused by the next allocations of the same size class. So the heap is only
+// touched when the arena grows, and everything goes back to it at once in release() (or when the arena dies).
+//
+// The polynomials are pointed to the arena by their allocator (see ArenaStorage below):
+//     Arena arena;
+//     {
+//         Arena::Scope scope(arena);
+//         EEuclideanResult<Polynomial<T, ArenaStorage<T> > > result = extended_euclidean(a, b);
+//         ... copy what is needed out of the result ...
+//     }
+//     arena.release();
+// An ArenaAllocator allocates from the current arena of the thread it was made on (or from the heap,
+// if there is none). Copies of polynomials are made in the current arena of the copying thread, but a moved
+// polynomial keeps its buffer, so nothing moved out of a scope may outlive the release of its arena.
+//
+// An arena is not synchronised: it should be used by one thread at a time (like one computation per worker).
+class Arena
+{
+    public:
+        // The arena takes blocks of at least the given size from the heap.
+        explicit Arena(size_t block_size = 64 * 1024);
+        ~Arena();
+
+        Arena(const Arena&) = delete;
+        Arena& operator = (const Arena&) = delete;
+
+        void* allocate(const size_t bytes);
+        void deallocate(void* pointer, const size_t bytes);
+
+        // Return every block to the heap. Nothing allocated from the arena may be used after this.
+        void release();
+
+        // The bytes taken from the heap
+        size_t reserved() const { return this->m_reserved; }
+
+        // The arena of the calling thread (nullptr if there is none).
+        static Arena* current() { return Arena::s_current; }
+
+        // Make an arena the current one of the calling thread while the scope lives.
+        // (Scopes can be nested, the previous arena is restored at the end.)
+        class Scope
+        {
+            public:
+                explicit Scope(Arena& arena) : m_previous(Arena::s_current)
+                {
+                    Arena::s_current = &arena;
+                }
+
+                ~Scope() { Arena::s_current = this->m_previous; }
+
+                Scope(const Scope&) = delete;
+                Scope& operator = (const Scope&) = delete;
+
+            private:
+                Arena* m_previous;
+        };
+
+    private:
+        // Every piece is a power of two, aligned for any fundamental type.
+        static const size_t s_minimumClass = 4; // 16 bytes
+        static const size_t s_classes = 48;
+
+        // Freed pieces of a size class, linked through their first bytes
+        struct FreePiece
+        {
+            FreePiece* next;
+        };
+
+        size_t m_blockSize;
+        std::vector<void*> m_blocks;
+        char* m_next;
+        char* m_end;
+        size_t m_reserved;
+        FreePiece* m_free[s_classes];
+
+        static inline thread_local Arena* s_current = nullptr;
+
+        // The size class of a request: the exponent of its size rounded up to a power of two
+        static size_t sizeClass(const size_t bytes);
+};
+
+inline Arena::Arena(size_t block_size)
+    : m_blockSize(block_size), m_next(nullptr), m_end(nullptr), m_reserved(0)
+{
+    for (size_t i = 0; i < s_classes; ++i)
+        this->m_free[i] = nullptr;
+}
+
+inline Arena::~Arena()
+{
+    this->release();
+}
+
+inline size_t Arena::sizeClass(const size_t bytes)
+{
+    size_t size_class = s_minimumClass;
+    while ((size_t(1) << size_class) < bytes)
+        ++size_class;
+
+    return size_class;
+}
+
+inline void* Arena::allocate(const size_t bytes)
+{
+    const size_t size_class = sizeClass(bytes);
+    if (size_class >= s_classes)
+        throw std::bad_alloc();
+
+    // A freed piece of the same size, if there is one
+    if (this->m_free[size_class] != nullptr)
+    {
+        FreePiece* piece = this->m_free[size_class];
+        this->m_free[size_class] = piece->next;
+        return piece;
+    }
+
+    const size_t size = size_t(1) << size_class;
+    if (static_cast<size_t>(this->m_end - this->m_next) < size)
+    {
+        // A new block (the rest of the current one is left unused). Large pieces get a block of their own.
+        const size_t block_size = size > this->m_blockSize ? size : this->m_blockSize;
+        char* block = static_cast<char*>(::operator new(block_size));
+
+        this->m_blocks.push_back(block);
+        this->m_reserved += block_size;
+        this->m_next = block;
+        this->m_end = block + block_size;
+    }
+
+    // (The blocks are aligned for any fundamental type, and every piece is a multiple of that alignment.)
+    void* piece = this->m_next;
+    this->m_next += size;
+    return piece;
+}
+
+inline void Arena::deallocate(void* pointer, const size_t bytes)
+{
+    if (pointer == nullptr)
+        return;
+
+    const size_t size_class = sizeClass(bytes);
+    FreePiece* piece = static_cast<FreePiece*>(pointer);
+    piece->next = this->m_free[size_class];
+    this->m_free[size_class] = piece;
+}
+
+inline void Arena::release()
+{
+    for (void* block : this->m_blocks)
+        ::operator delete(block);
+
+    this->m_blocks.clear();
+    this->m_next = this->m_end = nullptr;
+    this->m_reserved = 0;
+    for (size_t i = 0; i < s_classes; ++i)
+        this->m_free[i] = nullptr;
+}
+
+// Standard allocator on an Arena: the current arena of the thread at its construction,
+// or the heap if there is none.
+template<typename T>
+class ArenaAllocator
+{
+    public:
+        typedef T value_type;
+
+        static_assert(alignof(T) <= alignof(std::max_align_t), "The arena only aligns for the fundamental types");
+
+        // Buffers moved (or swapped) to another container stay in their arena.
+        typedef std::true_type propagate_on_container_move_assignment;
+        typedef std::true_type propagate_on_container_swap;
+        typedef std::false_type propagate_on_container_copy_assignment;
+        typedef std::false_type is_always_equal;
+
+        ArenaAllocator() noexcept : m_arena(Arena::current()) {}
+        explicit ArenaAllocator(Arena* arena) noexcept : m_arena(arena) {}
+
+        template<typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) noexcept : m_arena(other.arena()) {}
+
+        T* allocate(const size_t n)
+        {
+            Instrumentation::allocation(n * sizeof(T));
+            if (this->m_arena == nullptr)
+                return static_cast<T*>(::operator new(n * sizeof(T)));
+
+            return static_cast<T*>(this->m_arena->allocate(n * sizeof(T)));
+        }
+
+        void deallocate(T* pointer, const size_t n) noexcept
+        {
+            if (this->m_arena == nullptr)
+                ::operator delete(pointer);
+            else
+                this->m_arena->deallocate(pointer, n * sizeof(T));
+        }
+
+        // Copies of a container go to the current arena of the copying thread.
+        ArenaAllocator<T> select_on_container_copy_construction() const { return ArenaAllocator<T>(); }
+
+        Arena* arena() const { return this->m_arena; }
+
+    private:
+        Arena* m_arena;
+};
+
+template<typename T, typename U>
+bool operator == (const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena() == b.arena(); }
+
+template<typename T, typename U>
+bool operator != (const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena() != b.arena(); }
+
+// The storage policies of polynomials computed in the current arena (see PolynomialStorage.hpp)
+template<typename T>
+using ArenaStorage = DenseStorage<T, ArenaAllocator<T> >;
+
+template<typename T>
+using SparseArenaStorage = SparseStorage<T, ArenaAllocator<T> >;
+
+#endif // _ARENA_ALLOCATOR_H
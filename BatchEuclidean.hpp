@@ -0,0 +1,111 @@
+#ifndef _BATCH_EUCLIDEAN_H
+#define _BATCH_EUCLIDEAN_H
+
+#include <cstddef>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include "EuclideanAlgorithm.hpp"
+#include "Polynomial.hpp"
+#include "BatchThreadState.hpp"
+#include "ThreadPool.hpp"
+
+// The (extended) Euclidean algorithm of many independent pairs at once, on the workers of a ThreadPool.
+//
+// The pairs are started in descending order of their estimated cost, so the expensive ones don't end up
+// running alone at the end (see ThreadPool.hpp). The results are in the order of the pairs.
+
+// The estimated cost of the Euclidean algorithm of a pair: the product of the sizes for types with a degree
+// (the classical algorithm of polynomials is O(deg a * deg b)), the same for every pair otherwise.
+template<typename T, typename = void>
+struct euclidean_cost
+{
+    static double estimate(const T&, const T&) { return 1; }
+};
+
+template<typename T>
+struct euclidean_cost<T, std::void_t<decltype(std::declval<const T&>().degree())> >
+{
+    static double estimate(const T& a, const T& b)
+    {
+        return (static_cast<double>(a.degree()) + 1) * (static_cast<double>(b.degree()) + 1);
+    }
+};
+
+// Polynomials need the state of their coefficients (see BatchThreadState.hpp).
+template<typename T, typename Storage>
+struct batch_thread_state<Polynomial<T, Storage> >
+{
+    batch_thread_state<T> coefficients;
+
+    static batch_thread_state<Polynomial<T, Storage> > capture() { return { batch_thread_state<T>::capture() }; }
+
+    struct Scope
+    {
+        typename batch_thread_state<T>::Scope scope;
+
+        explicit Scope(const batch_thread_state<Polynomial<T, Storage> >& state) : scope(state.coefficients) {}
+    };
+};
+
+// Run compute(i) for the n pairs on the pool, the most expensive first.
+template<typename T, typename F>
+void batch_run(const std::pair<T, T>* pairs, const size_t n, ThreadPool& pool, F compute)
+{
+    std::vector<double> costs(n);
+    for (size_t i = 0; i < n; ++i)
+        costs[i] = euclidean_cost<T>::estimate(pairs[i].first, pairs[i].second);
+
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&costs](const size_t i, const size_t j) { return costs[i] > costs[j]; });
+
+    const batch_thread_state<T> state = batch_thread_state<T>::capture();
+    pool.run(order, [&state, &compute](const size_t i)
+    {
+        const typename batch_thread_state<T>::Scope scope(state);
+        compute(i);
+    });
+}
+
+// The extended Euclidean algorithm of every pair (a, b). (See extended_euclidean.)
+template<typename T>
+std::vector<EEuclideanResult<T> > batch_extended_euclidean(const std::pair<T, T>* pairs, const size_t n, ThreadPool& pool)
+{
+    std::vector<EEuclideanResult<T> > results(n);
+    batch_run(pairs, n, pool, [pairs, &results](const size_t i)
+    {
+        results[i] = extended_euclidean<T>(pairs[i].first, pairs[i].second);
+    });
+
+    return results;
+}
+
+template<typename T>
+std::vector<EEuclideanResult<T> > batch_extended_euclidean(const std::vector<std::pair<T, T> >& pairs, ThreadPool& pool)
+{
+    return batch_extended_euclidean(pairs.data(), pairs.size(), pool);
+}
+
+// The GCD of every pair (a, b). (See euclidean.)
+template<typename T>
+std::vector<T> batch_euclidean(const std::pair<T, T>* pairs, const size_t n, ThreadPool& pool)
+{
+    std::vector<T> results(n);
+    batch_run(pairs, n, pool, [pairs, &results](const size_t i)
+    {
+        results[i] = euclidean<T>(pairs[i].first, pairs[i].second);
+    });
+
+    return results;
+}
+
+template<typename T>
+std::vector<T> batch_euclidean(const std::vector<std::pair<T, T> >& pairs, ThreadPool& pool)
+{
+    return batch_euclidean(pairs.data(), pairs.size(), pool);
+}
+
+#endif // _BATCH_EUCLIDEAN_H
@@ -0,0 +1,21 @@
+#ifndef _BATCH_THREAD_STATE_H
+#define _BATCH_THREAD_STATE_H
+
+// State of the calling thread which the workers need to compute with T, like the current ResidueContext
+// of RuntimeResidueNum (see Residue.hpp). capture() is called on the calling thread, and a Scope of the state is
+// alive on the worker while it computes (see BatchEuclidean.hpp). By default there is none.
+//
+// (This is apart from BatchEuclidean.hpp, so that the specialisations can be declared with their types,
+// whatever the order of the includes.)
+template<typename T>
+struct batch_thread_state
+{
+    static batch_thread_state<T> capture() { return batch_thread_state<T>(); }
+
+    struct Scope
+    {
+        explicit Scope(const batch_thread_state<T>&) {}
+    };
+};
+
+#endif // _BATCH_THREAD_STATE_H
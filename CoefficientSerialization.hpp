@@ -0,0 +1,86 @@
+#ifndef _COEFFICIENT_SERIALIZATION_H
+#define _COEFFICIENT_SERIALIZATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// The format of the coefficients in a serialized polynomial (see PolynomialSerialization.hpp).
+//
+// (This is apart from PolynomialSerialization.hpp, so that the specialisations can be declared with their types,
+// whatever the order of the includes.)
+
+enum serialized_coefficient_type
+{
+    serialized_signed = 1,   // Signed integers (two's complement)
+    serialized_unsigned = 2, // Unsigned integers
+    serialized_floating = 3, // IEEE 754 floating-point numbers
+    serialized_residue = 4,  // Residues modulo the modulus of the header, as their number in [0, modulus)
+    serialized_gf2 = 5,      // Bits (see GF2Polynomial)
+    serialized_montgomery = 6 // Residues modulo an odd modulus, in Montgomery form (only in the native layout)
+};
+
+// The packing of the coefficients of T into the payload: the built-in arithmetic types by default.
+// Specialise this for other coefficient types (see Residue.hpp), with the same members.
+template<typename T>
+struct coefficient_serialization
+{
+    static_assert(std::is_arithmetic<T>::value && sizeof(T) <= 8,
+        "The coefficient type has no binary format: specialise coefficient_serialization for it");
+
+    static const serialized_coefficient_type type =
+        std::is_floating_point<T>::value ? serialized_floating :
+        std::is_signed<T>::value ? serialized_signed : serialized_unsigned;
+
+    // The type of the coefficients in the native layout: their bytes in memory have to be the same for every
+    // program with the same type (0 if there is no native layout)
+    static const serialized_coefficient_type native_type = type;
+
+    // The modulus of the coefficients (0 if they are not residues)
+    static uint64_t modulus() { return 0; }
+
+    // The bytes of a coefficient in the payload (at most 8)
+    static size_t width() { return sizeof(T); }
+
+    // The bits of a coefficient (in the lowest width() bytes), and back.
+    // unpack() throws std::invalid_argument if the bits are not a coefficient.
+    static uint64_t pack(const T& coefficient)
+    {
+        if constexpr (std::is_floating_point<T>::value)
+        {
+            typename std::conditional<sizeof(T) == 8, uint64_t, uint32_t>::type bits;
+            static_assert(sizeof(bits) == sizeof(T), "Unsupported floating-point type");
+            std::memcpy(&bits, &coefficient, sizeof(T));
+            return bits;
+        }
+        else
+            return static_cast<uint64_t>(static_cast<typename std::make_unsigned<T>::type>(coefficient));
+    }
+
+    static T unpack(const uint64_t bits)
+    {
+        if constexpr (std::is_floating_point<T>::value)
+        {
+            typename std::conditional<sizeof(T) == 8, uint64_t, uint32_t>::type narrow =
+                static_cast<typename std::conditional<sizeof(T) == 8, uint64_t, uint32_t>::type>(bits);
+            T coefficient;
+            std::memcpy(&coefficient, &narrow, sizeof(T));
+            return coefficient;
+        }
+        else
+            return static_cast<T>(static_cast<typename std::make_unsigned<T>::type>(bits));
+    }
+};
+
+// The bytes needed for the numbers in [0, modulus)
+inline size_t serialized_residue_width(const uint64_t modulus)
+{
+    size_t width = 1;
+    while (width < 8 && ((modulus - 1) >> (8 * width)) != 0)
+        ++width;
+
+    return width;
+}
+
+#endif // _COEFFICIENT_SERIALIZATION_H
@@ -0,0 +1,53 @@
+#ifndef _COEFFICIENT_TEXT_H
+#define _COEFFICIENT_TEXT_H
+
+#include <charconv>
+#include <system_error>
+
+// The text of the coefficients of the polynomials (see PolynomialText.hpp).
+//
+// (This is apart from PolynomialText.hpp, so that the specialisations can be declared with their types,
+// whatever the order of the includes.)
+
+// The text of the coefficients of T. Specialise this for other coefficient types (see Residue.hpp), with the same members.
+template<typename T>
+struct coefficient_text
+{
+    static const bool known = false;
+};
+
+template<typename T>
+struct coefficient_text_integral
+{
+    static const bool known = true;
+
+    static std::to_chars_result format(char* first, char* last, const T value) { return std::to_chars(first, last, value); }
+    static std::from_chars_result parse(const char* first, const char* last, T& value) { return std::from_chars(first, last, value); }
+};
+
+// (Formatted as the streams print them by default: the shorter of the fixed and the scientific notation,
+// with 6 significant digits.)
+template<typename T>
+struct coefficient_text_floating
+{
+    static const bool known = true;
+
+    static std::to_chars_result format(char* first, char* last, const T value) { return std::to_chars(first, last, value, std::chars_format::general, 6); }
+    static std::from_chars_result parse(const char* first, const char* last, T& value) { return std::from_chars(first, last, value); }
+};
+
+// (Not the character types: the streams print those as characters.)
+template<> struct coefficient_text<unsigned short> : coefficient_text_integral<unsigned short>{};
+template<> struct coefficient_text<signed short> : coefficient_text_integral<signed short>{};
+template<> struct coefficient_text<unsigned int> : coefficient_text_integral<unsigned int>{};
+template<> struct coefficient_text<signed int> : coefficient_text_integral<signed int>{};
+template<> struct coefficient_text<unsigned long> : coefficient_text_integral<unsigned long>{};
+template<> struct coefficient_text<signed long> : coefficient_text_integral<signed long>{};
+template<> struct coefficient_text<unsigned long long> : coefficient_text_integral<unsigned long long>{};
+template<> struct coefficient_text<signed long long> : coefficient_text_integral<signed long long>{};
+
+template<> struct coefficient_text<float> : coefficient_text_floating<float>{};
+template<> struct coefficient_text<double> : coefficient_text_floating<double>{};
+template<> struct coefficient_text<long double> : coefficient_text_floating<long double>{};
+
+#endif // _COEFFICIENT_TEXT_H
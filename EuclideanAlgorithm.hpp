@@ -1,7 +1,26 @@
 #ifndef _EUCLIDEAN_ALGO_H
 #define _EUCLIDEAN_ALGO_H
 
+#include <utility>
 #include "add_mult_identity.hpp"
+#include "Instrumentation.hpp"
+
+// Calculate the quotient and the remainder of a / b together.
+// By default this is just the two operators: types which can do both in one pass overload it.
+template<typename T>
+void divmod(const T& a, const T& b, T& quotient, T& remainder)
+{
+    quotient = a / b;
+    remainder = a % b;
+}
+
+// a = a - q * b, the update of the Bezout coefficients in every step of the extended algorithm.
+// By default this is just the operators: types which can do it in place overload it.
+template<typename T>
+void submul(T& a, const T& q, const T& b)
+{
+    a = a - q * b;
+}
 
 template<typename T>
 T euclidean(const T& a_orig, const T& b_orig)
@@ -18,12 +37,25 @@ T euclidean(const T& a_orig, const T& b_orig)
         b = c;
     }
 
-    c = a % b; // Get the first remainder
-    while (c > id_additive<T>::value)
+    // (gcd(a, 0) = a)
+    if (b == id_additive<T>::value)
+        return a;
+
+    Instrumentation::iteration(b);
+    {
+        Instrumentation::PhaseTimer timer(phase_division);
+        c = a % b; // Get the first remainder
+    }
+
+    // The sequence ends at the first zero remainder (see classical_extended_euclidean).
+    while (c != id_additive<T>::value)
     {
         // While there is a remainder, always modulo the previous right-hand operand with the previous remainder.
-        a = b;
-        b = c;
+        a = std::move(b);
+        b = std::move(c);
+
+        Instrumentation::iteration(b);
+        Instrumentation::PhaseTimer timer(phase_division);
         c = a % b;
     }
 
@@ -48,10 +80,16 @@ struct EEuclideanResult
     T a;
     T y; // the coefficient for b
     T b;
+
+#ifdef POLYNOMIAL_INSTRUMENTATION
+    // The work done for this result (filled in by extended_euclidean, see Instrumentation.hpp)
+    InstrumentationStats stats;
+#endif
 };
 
+// The classical extended Euclidean algorithm, going through the whole remainder sequence.
 template<typename T>
-EEuclideanResult<T> extended_euclidean(const T& a_orig, const T& b_orig)
+EEuclideanResult<T> classical_extended_euclidean(const T& a_orig, const T& b_orig)
 {
     T a = a_orig;
     T b = b_orig;
@@ -61,36 +99,80 @@ EEuclideanResult<T> extended_euclidean(const T& a_orig, const T& b_orig)
     T x0 = id_multiplicative<T>::value;
     T y0 = id_additive<T>::value;
 
+    // (If the first remainder is already zero, b is the GCD: 0 * a + 1 * b.)
     T x1 = id_additive<T>::value;
     T y1 = id_multiplicative<T>::value;
 
-    T xn = id_multiplicative<T>::value;
-    T yn = id_multiplicative<T>::value;
+    EEuclideanResult<T> result;
+    result.a = a_orig;  result.b = b_orig;
+
+    // (gcd(a, 0) = a = 1 * a + 0 * b, without dividing by zero.)
+    if (b == id_additive<T>::value)
+    {
+        result.gcd = std::move(a);
+        result.x = std::move(x0); result.y = std::move(y0);
+        return result;
+    }
 
     T q;
-    T r = a % b;
-    
-    while (r > id_additive<T>::value)
+    T r;
+    Instrumentation::iteration(b);
+    {
+        Instrumentation::PhaseTimer timer(phase_division);
+        divmod(a, b, q, r);
+    }
+
+    // The sequence ends at the first zero remainder. (Comparing by order would stop too early for
+    // polynomials, whose order is the degree: a non-zero constant remainder still has to be divided.)
+    while (r != id_additive<T>::value)
     {
         // Apart from calculating the GCD, the extended euclidean algorithm also calculates a linear combination
         // of the two arguments which result in said GCD.
-        q = a / b;
-        xn = x0 - q * x1;
-        yn = y0 - q * y1;
+        // xn = x0 - q * x1, computed in place of x0, which is then the older one of the two.
+        {
+            Instrumentation::PhaseTimer timer(phase_cofactors);
+            submul(x0, q, x1);
+            submul(y0, q, y1);
+        }
+
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+
+        a = std::move(b);
+        b = std::move(r);
+
+        Instrumentation::iteration(b);
+        Instrumentation::PhaseTimer timer(phase_division);
+        divmod(a, b, q, r);
+    }
 
-        x0 = x1; y0 = y1;
-        x1 = xn; y1 = yn;
+    result.gcd = std::move(b);
+    result.x = std::move(x1); result.y = std::move(y1);
+    return result;
+}
 
-        a = b;
-        b = r;
-        r = a % b;
+// Choose the algorithm computing the extended Euclidean algorithm for T.
+// Types with a faster algorithm specialise this (see HalfGCD.hpp).
+template<typename T>
+struct extended_euclidean_strategy
+{
+    static EEuclideanResult<T> compute(const T& a, const T& b)
+    {
+        return classical_extended_euclidean<T>(a, b);
     }
+};
 
-    EEuclideanResult<T> result;
-    result.gcd = b;
-    result.a = a_orig;  result.b = b_orig;
-    result.x = xn; result.y = yn;
+template<typename T>
+EEuclideanResult<T> extended_euclidean(const T& a_orig, const T& b_orig)
+{
+#ifdef POLYNOMIAL_INSTRUMENTATION
+    const InstrumentationStats before = Instrumentation::snapshot();
+    EEuclideanResult<T> result = extended_euclidean_strategy<T>::compute(a_orig, b_orig);
+    result.stats = Instrumentation::stats().since(before);
     return result;
+#else
+    return extended_euclidean_strategy<T>::compute(a_orig, b_orig);
+#endif
 }
 
 #endif // _EUCLIDEAN_ALGO_H
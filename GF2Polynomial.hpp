@@ -0,0 +1,607 @@
+#ifndef _GF2_POLYNOMIAL_H
+#define _GF2_POLYNOMIAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include <algorithm>
+#include "add_mult_identity.hpp"
+#include "EuclideanAlgorithm.hpp"
+#include "PolynomialThresholds.hpp"
+#include "Polynomial.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define _GF2_PCLMUL_AVAILABLE
+#endif
+
+// Polynomials over GF(2) (that is: Z_2), with the coefficients packed 64 to a word.
+//
+// Every coefficient is a bit: bit i of word w is the coefficient of x^(64w + i).
+// Addition and subtraction are both XOR, so they take one instruction for 64 members, and multiplication
+// is the carry-less product of the words (PCLMULQDQ where the processor has it).
+
+/* Carry-less multiplication kernels */
+
+// The carry-less product of two words (128 bits, as the low and the high word), without special instructions.
+inline void gf2_clmul_portable(const uint64_t a, const uint64_t b, uint64_t& low, uint64_t& high)
+{
+    // The products of b with every 4-bit number, then a is processed 4 bits at a time from the top.
+    typedef unsigned __int128 uint128;
+    uint128 table[16];
+    table[0] = 0;
+    for (unsigned i = 1; i < 16; ++i)
+        table[i] = (i & 1 ? uint128(b) : uint128(0)) ^ (table[i >> 1] << 1);
+
+    uint128 product = 0;
+    for (int shift = 60; shift >= 0; shift -= 4)
+        product = (product << 4) ^ table[(a >> shift) & 0xF];
+
+    low = static_cast<uint64_t>(product);
+    high = static_cast<uint64_t>(product >> 64);
+}
+
+// Schoolbook product of a (n words) and b (m words), XOR-ed into out (n + m words).
+inline void gf2_multiply_words_portable(const uint64_t* a, const size_t n, const uint64_t* b, const size_t m, uint64_t* out)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (a[i] == 0) continue;
+
+        for (size_t j = 0; j < m; ++j)
+        {
+            uint64_t low, high;
+            gf2_clmul_portable(a[i], b[j], low, high);
+            out[i + j] ^= low;
+            out[i + j + 1] ^= high;
+        }
+    }
+}
+
+#ifdef _GF2_PCLMUL_AVAILABLE
+// The same with PCLMULQDQ. (Only called if the processor supports it, see gf2_multiply_words.)
+__attribute__((target("pclmul,sse2")))
+inline void gf2_multiply_words_pclmul(const uint64_t* a, const size_t n, const uint64_t* b, const size_t m, uint64_t* out)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (a[i] == 0) continue;
+
+        const __m128i left = _mm_cvtsi64_si128(static_cast<long long>(a[i]));
+        for (size_t j = 0; j < m; ++j)
+        {
+            const __m128i product = _mm_clmulepi64_si128(left, _mm_cvtsi64_si128(static_cast<long long>(b[j])), 0x00);
+            out[i + j] ^= static_cast<uint64_t>(_mm_cvtsi128_si64(product));
+            out[i + j + 1] ^= static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(product, product)));
+        }
+    }
+}
+#endif // _GF2_PCLMUL_AVAILABLE
+
+// Schoolbook product of a (n words) and b (m words), XOR-ed into out (n + m words),
+// by the fastest carry-less multiplication the processor has.
+inline void gf2_multiply_words(const uint64_t* a, const size_t n, const uint64_t* b, const size_t m, uint64_t* out)
+{
+#ifdef _GF2_PCLMUL_AVAILABLE
+    static const bool pclmul = __builtin_cpu_supports("pclmul");
+    if (pclmul)
+    {
+        gf2_multiply_words_pclmul(a, n, b, m, out);
+        return;
+    }
+#endif // _GF2_PCLMUL_AVAILABLE
+
+    gf2_multiply_words_portable(a, n, b, m, out);
+}
+
+// Size of the scratch space needed by gf2_karatsuba_multiply for operands of n words.
+inline size_t gf2_karatsuba_scratch_size(size_t n)
+{
+    size_t size = 0;
+    while (n >= polynomial_thresholds::gf2_karatsuba && n > 1)
+    {
+        // The two sums of the halves and their product on every level of the recursion
+        const size_t high = n - n / 2;
+        size += 4 * high;
+        n = high;
+    }
+
+    return size;
+}
+
+// Karatsuba's method for operands of n words each. (See PolynomialMultiply.hpp; here - is XOR as well.)
+// (out has to have room for 2n words, which are overwritten, scratch for gf2_karatsuba_scratch_size(n))
+inline void gf2_karatsuba_multiply(const uint64_t* a, const uint64_t* b, const size_t n, uint64_t* out, uint64_t* scratch)
+{
+    if (n < polynomial_thresholds::gf2_karatsuba || n == 1)
+    {
+        std::fill(out, out + 2 * n, 0);
+        gf2_multiply_words(a, n, b, n, out);
+        return;
+    }
+
+    const size_t low = n / 2;
+    const size_t high = n - low;
+
+    gf2_karatsuba_multiply(a, b, low, out, scratch);
+    gf2_karatsuba_multiply(a + low, b + low, high, out + 2 * low, scratch);
+
+    uint64_t* a_sum = scratch;
+    uint64_t* b_sum = a_sum + high;
+    uint64_t* middle = b_sum + high;
+    uint64_t* rest = middle + 2 * high;
+
+    for (size_t i = 0; i < high; ++i)
+    {
+        a_sum[i] = (i < low ? a[i] ^ a[low + i] : a[low + i]);
+        b_sum[i] = (i < low ? b[i] ^ b[low + i] : b[low + i]);
+    }
+
+    gf2_karatsuba_multiply(a_sum, b_sum, high, middle, rest);
+
+    for (size_t i = 0; i < 2 * low; ++i)
+        middle[i] ^= out[i];
+    for (size_t i = 0; i < 2 * high; ++i)
+        middle[i] ^= out[2 * low + i];
+
+    for (size_t i = 0; i < 2 * high; ++i)
+        out[low + i] ^= middle[i];
+}
+
+class GF2Polynomial
+{
+    public:
+        /* Constructors */
+        // Default constructor (the nullpolynomial)
+        GF2Polynomial() {}
+
+        // Constant polynomial 0 or 1
+        explicit GF2Polynomial(const bool coefficient)
+        {
+            if (coefficient)
+                this->m_words.push_back(1);
+        }
+
+        // Conversion from a polynomial over Z_2 (or any ring, where the non-zero coefficients are taken as 1)
+        template<typename T, typename Storage>
+        explicit GF2Polynomial(const Polynomial<T, Storage>& poly);
+
+        // The polynomial of the given words (bit i of word w is the coefficient of x^(64w + i))
+        static GF2Polynomial fromWords(const std::vector<uint64_t>& words)
+        {
+            GF2Polynomial result;
+            result.m_words = words;
+            result.normalize();
+            return result;
+        }
+
+        const std::vector<uint64_t>& words() const { return this->m_words; }
+
+        /* Operators */
+        friend GF2Polynomial operator + (const GF2Polynomial& a, const GF2Polynomial& b);
+        friend GF2Polynomial operator - (const GF2Polynomial& a, const GF2Polynomial& b);
+        friend GF2Polynomial operator * (const GF2Polynomial& a, const GF2Polynomial& b);
+        friend GF2Polynomial operator / (const GF2Polynomial& a, const GF2Polynomial& b);
+        friend GF2Polynomial operator % (const GF2Polynomial& a, const GF2Polynomial& b);
+
+        friend bool operator == (const GF2Polynomial& a, const GF2Polynomial& b) { return a.m_words == b.m_words; }
+        friend bool operator != (const GF2Polynomial& a, const GF2Polynomial& b) { return a.m_words != b.m_words; }
+
+        // Printing operator (in the format of Polynomial<>)
+        friend std::ostream& operator << (std::ostream& o, const GF2Polynomial& poly);
+
+        /* Member functions */
+        // Get the degree
+        size_t degree() const
+        {
+            if (this->m_words.empty())
+                return 0;
+
+            return 64 * (this->m_words.size() - 1) + topBit(this->m_words.back());
+        }
+
+        // Get or set the nth coefficient
+        bool getMember(const size_t index) const
+        {
+            const size_t word = index / 64;
+            return word < this->m_words.size() && ((this->m_words[word] >> (index % 64)) & 1);
+        }
+
+        void setMember(const size_t index, const bool coefficient);
+
+        // Algebraic derivative (prime): only the odd powers have an odd multiplier
+        GF2Polynomial derive() const;
+
+        // Arithmetical methods
+        void add(const GF2Polynomial& poly);
+        void multiply(const GF2Polynomial& poly);
+        bool divide(const GF2Polynomial& divisor, GF2Polynomial& quotient, GF2Polynomial& remainder) const;
+
+        bool isNull() const { return this->m_words.empty(); }
+        bool isConstant() const { return this->m_words.size() == 1 && this->m_words[0] == 1; }
+
+    private:
+        // The invariant is that the highest word is not 0 (the nullpolynomial has no words).
+        std::vector<uint64_t> m_words;
+
+        void normalize()
+        {
+            while (!this->m_words.empty() && this->m_words.back() == 0)
+                this->m_words.pop_back();
+        }
+
+        // Index of the highest set bit of a non-zero word
+        static size_t topBit(const uint64_t word)
+        {
+            return 63 - static_cast<size_t>(__builtin_clzll(word));
+        }
+
+        // target ^= source * x^shift (target grows as needed, and it is not normalised)
+        static void xorShifted(std::vector<uint64_t>& target, const std::vector<uint64_t>& source, const size_t shift);
+
+        // Reduce the remainder by the divisor in place, until its degree is below the divisor's.
+        // Every step XORs the divisor shifted by some power onto it, and reports that power to onStep.
+        template<typename F>
+        static void reduce(std::vector<uint64_t>& remainder, const GF2Polynomial& divisor, F onStep);
+
+        friend GF2Polynomial gf2_euclidean(const GF2Polynomial& a_orig, const GF2Polynomial& b_orig);
+        friend EEuclideanResult<GF2Polynomial> gf2_extended_euclidean(const GF2Polynomial& a_orig, const GF2Polynomial& b_orig);
+};
+
+template<typename T, typename Storage>
+GF2Polynomial::GF2Polynomial(const Polynomial<T, Storage>& poly)
+{
+    if (poly.isNull())
+        return;
+
+    this->m_words.resize(poly.degree() / 64 + 1, 0);
+    for (size_t i = 0; i <= poly.degree(); ++i)
+        if (poly.getMember(i) != id_additive<T>::value)
+            this->m_words[i / 64] |= uint64_t(1) << (i % 64);
+}
+
+inline void GF2Polynomial::setMember(const size_t index, const bool coefficient)
+{
+    const size_t word = index / 64;
+    const uint64_t bit = uint64_t(1) << (index % 64);
+    if (coefficient)
+    {
+        if (word >= this->m_words.size())
+            this->m_words.resize(word + 1, 0);
+        this->m_words[word] |= bit;
+    }
+    else if (word < this->m_words.size())
+    {
+        this->m_words[word] &= ~bit;
+        this->normalize();
+    }
+}
+
+inline GF2Polynomial GF2Polynomial::derive() const
+{
+    // (x^k)' = k x^(k-1), where k is 1 for odd and 0 for even k: the odd members are shifted down by one.
+    GF2Polynomial derivative;
+    derivative.m_words.resize(this->m_words.size());
+    for (size_t i = 0; i < this->m_words.size(); ++i)
+        derivative.m_words[i] = (this->m_words[i] >> 1) & 0x5555555555555555ULL;
+
+    derivative.normalize();
+    return derivative;
+}
+
+inline void GF2Polynomial::add(const GF2Polynomial& poly)
+{
+    if (this->m_words.size() < poly.m_words.size())
+        this->m_words.resize(poly.m_words.size(), 0);
+
+    for (size_t i = 0; i < poly.m_words.size(); ++i)
+        this->m_words[i] ^= poly.m_words[i];
+
+    // The leading words might have cancelled out each other.
+    this->normalize();
+}
+
+inline void GF2Polynomial::multiply(const GF2Polynomial& poly)
+{
+    if (this->isNull() || poly.isNull())
+    {
+        this->m_words.clear();
+        return;
+    }
+
+    const std::vector<uint64_t>* a = &this->m_words;
+    const std::vector<uint64_t>* b = &poly.m_words;
+    if (a->size() < b->size())
+        std::swap(a, b);
+
+    const size_t n = a->size();
+    const size_t m = b->size();
+    std::vector<uint64_t> product(n + m, 0);
+
+    if (m < polynomial_thresholds::gf2_karatsuba)
+        gf2_multiply_words(a->data(), n, b->data(), m, product.data());
+    else
+    {
+        // Multiply b with every m-word chunk of a by Karatsuba's method, and add them up with the right shift.
+        std::vector<uint64_t> chunk(m);
+        std::vector<uint64_t> chunk_product(2 * m);
+        std::vector<uint64_t> scratch(gf2_karatsuba_scratch_size(m));
+        for (size_t offset = 0; offset < n; offset += m)
+        {
+            const size_t length = std::min(m, n - offset);
+            std::copy(a->begin() + offset, a->begin() + offset + length, chunk.begin());
+            std::fill(chunk.begin() + length, chunk.end(), 0);
+
+            gf2_karatsuba_multiply(chunk.data(), b->data(), m, chunk_product.data(), scratch.data());
+
+            for (size_t i = 0; i < length + m; ++i)
+                product[offset + i] ^= chunk_product[i];
+        }
+    }
+
+    this->m_words.swap(product);
+    this->normalize();
+}
+
+inline void GF2Polynomial::xorShifted(std::vector<uint64_t>& target, const std::vector<uint64_t>& source, const size_t shift)
+{
+    const size_t word_shift = shift / 64;
+    const unsigned bit_shift = shift % 64;
+
+    const size_t needed = source.size() + word_shift + (bit_shift != 0 ? 1 : 0);
+    if (target.size() < needed)
+        target.resize(needed, 0);
+
+    uint64_t* out = target.data() + word_shift;
+    if (bit_shift == 0)
+    {
+        for (size_t i = 0; i < source.size(); ++i)
+            out[i] ^= source[i];
+    }
+    else
+    {
+        for (size_t i = 0; i < source.size(); ++i)
+        {
+            out[i] ^= source[i] << bit_shift;
+            out[i + 1] ^= source[i] >> (64 - bit_shift);
+        }
+    }
+}
+
+template<typename F>
+void GF2Polynomial::reduce(std::vector<uint64_t>& remainder, const GF2Polynomial& divisor, F onStep)
+{
+    const size_t divisor_degree = divisor.degree();
+
+    while (!remainder.empty())
+    {
+        const size_t remainder_degree = 64 * (remainder.size() - 1) + topBit(remainder.back());
+        if (remainder_degree < divisor_degree)
+            break;
+
+        // The divisor shifted under the LC of the remainder eliminates it.
+        const size_t shift = remainder_degree - divisor_degree;
+        xorShifted(remainder, divisor.m_words, shift);
+        onStep(shift);
+
+        while (!remainder.empty() && remainder.back() == 0)
+            remainder.pop_back();
+    }
+}
+
+inline bool GF2Polynomial::divide(const GF2Polynomial& divisor, GF2Polynomial& quotient, GF2Polynomial& remainder) const
+{
+    if (divisor.isNull())
+        return false;
+
+    std::vector<uint64_t> rest = this->m_words;
+    std::vector<uint64_t> quotient_words;
+    if (this->degree() >= divisor.degree() && !this->isNull())
+        quotient_words.resize((this->degree() - divisor.degree()) / 64 + 1, 0);
+
+    // Every step sets one member of the quotient.
+    reduce(rest, divisor, [&quotient_words](const size_t shift)
+    {
+        quotient_words[shift / 64] |= uint64_t(1) << (shift % 64);
+    });
+
+    quotient.m_words.swap(quotient_words);
+    quotient.normalize();
+    remainder.m_words.swap(rest);
+    remainder.normalize();
+    return true;
+}
+
+inline GF2Polynomial operator + (const GF2Polynomial& a, const GF2Polynomial& b)
+{
+    GF2Polynomial ret = a;
+    ret.add(b);
+    return ret;
+}
+
+// -1 = 1 in GF(2), so subtraction is addition
+inline GF2Polynomial operator - (const GF2Polynomial& a, const GF2Polynomial& b)
+{
+    return a + b;
+}
+
+inline GF2Polynomial operator * (const GF2Polynomial& a, const GF2Polynomial& b)
+{
+    GF2Polynomial ret = a;
+    ret.multiply(b);
+    return ret;
+}
+
+inline GF2Polynomial operator / (const GF2Polynomial& a, const GF2Polynomial& b)
+{
+    GF2Polynomial q, r;
+    a.divide(b, q, r);
+    return q;
+}
+
+inline GF2Polynomial operator % (const GF2Polynomial& a, const GF2Polynomial& b)
+{
+    GF2Polynomial q, r;
+    a.divide(b, q, r);
+    return r;
+}
+
+// Quotient and remainder of a / b at once (overloads the generic version of EuclideanAlgorithm.hpp)
+inline void divmod(const GF2Polynomial& a, const GF2Polynomial& b, GF2Polynomial& quotient, GF2Polynomial& remainder)
+{
+    a.divide(b, quotient, remainder);
+}
+
+// The 'phi' function of polynomials (in the Euclidean ring order) is their degree
+inline bool operator < (const GF2Polynomial& a, const GF2Polynomial& b) { return a.degree() < b.degree(); }
+inline bool operator <= (const GF2Polynomial& a, const GF2Polynomial& b) { return a.degree() <= b.degree(); }
+inline bool operator > (const GF2Polynomial& a, const GF2Polynomial& b) { return a.degree() > b.degree(); }
+inline bool operator >= (const GF2Polynomial& a, const GF2Polynomial& b) { return a.degree() >= b.degree(); }
+
+inline std::ostream& operator << (std::ostream& o, const GF2Polynomial& poly)
+{
+    if (poly.isNull())
+        return o << "0";
+
+    // Every member is 1 * x^power, so only the powers are printed.
+    bool firstCoeff = true;
+    for (size_t power = poly.degree() + 1; power-- > 0; )
+    {
+        if (!poly.getMember(power))
+            continue;
+
+        if (!firstCoeff)
+            o << " + ";
+
+        if (power > 1)
+            o << "x^" << power;
+        else if (power == 1)
+            o << "x";
+        else
+            o << "1";
+
+        firstCoeff = false;
+    }
+
+    return o;
+}
+
+// The polynomial over T with the same coefficients (1 is id_multiplicative<T>)
+template<typename T, typename Storage = DenseStorage<T> >
+Polynomial<T, Storage> gf2_to_polynomial(const GF2Polynomial& poly)
+{
+    Polynomial<T, Storage> result;
+    {
+        typename Polynomial<T, Storage>::BatchEdit batch(result);
+        batch.reserve(poly.degree());
+        for (size_t i = 0; i <= poly.degree(); ++i)
+            if (poly.getMember(i))
+                batch.setMember(i, id_multiplicative<T>::value);
+    }
+
+    return result;
+}
+
+// The additive and multiplicative identity are the constant 0 and 1 polynomials.
+template<> struct id_multiplicative_exists<GF2Polynomial> : id_multiplicative_known{};
+template<> struct id_multiplicative<GF2Polynomial> { static inline GF2Polynomial const value = GF2Polynomial(true); };
+
+template<> struct id_additive_exists<GF2Polynomial> : id_additive_known{};
+template<> struct id_additive<GF2Polynomial> { static inline GF2Polynomial const value = GF2Polynomial(); };
+
+// The Euclidean algorithm of GF(2) polynomials, reducing the words in place.
+inline GF2Polynomial gf2_euclidean(const GF2Polynomial& a_orig, const GF2Polynomial& b_orig)
+{
+    GF2Polynomial r0 = a_orig;
+    GF2Polynomial r1 = b_orig;
+
+    // The last non-zero remainder is the GCD. (gcd(a, 0) = a)
+    while (!r1.isNull())
+    {
+        Instrumentation::iteration(r1);
+        {
+            Instrumentation::PhaseTimer timer(phase_division);
+            GF2Polynomial::reduce(r0.m_words, r1, [](const size_t) {});
+        }
+        std::swap(r0, r1);
+    }
+
+    return r0;
+}
+
+// The extended Euclidean algorithm of GF(2) polynomials, working on the words in place.
+// The quotients are never built: each step XORs the divisor (and its Bezout coefficients) shifted onto
+// the remainder (and its coefficients), which are the same remainders and coefficients as the ones
+// of the classical algorithm.
+inline EEuclideanResult<GF2Polynomial> gf2_extended_euclidean(const GF2Polynomial& a_orig, const GF2Polynomial& b_orig)
+{
+    EEuclideanResult<GF2Polynomial> result;
+    result.a = a_orig; result.b = b_orig;
+
+    // gcd(a, 0) = a = 1 * a + 0 * b
+    if (b_orig.isNull())
+    {
+        result.gcd = a_orig;
+        result.x = id_multiplicative<GF2Polynomial>::value;
+        result.y = id_additive<GF2Polynomial>::value;
+        return result;
+    }
+
+    // (r0, x0, y0) and (r1, x1, y1) are two consecutive members of the remainder sequence,
+    // where r = x * a + y * b.
+    GF2Polynomial r0 = a_orig, x0(true), y0;
+    GF2Polynomial r1 = b_orig, x1, y1(true);
+
+    while (true)
+    {
+        // r0 mod r1, and the coefficients with it: x0 - q * x1, y0 - q * y1
+        // (The coefficients are updated within the division, whose time they are counted in.)
+        Instrumentation::iteration(r1);
+        {
+            Instrumentation::PhaseTimer timer(phase_division);
+            GF2Polynomial::reduce(r0.m_words, r1, [&x0, &y0, &x1, &y1](const size_t shift)
+            {
+                GF2Polynomial::xorShifted(x0.m_words, x1.m_words, shift);
+                GF2Polynomial::xorShifted(y0.m_words, y1.m_words, shift);
+            });
+            x0.normalize();
+            y0.normalize();
+        }
+
+        // The last non-zero remainder is the GCD.
+        if (r0.isNull())
+            break;
+
+        std::swap(r0, r1);
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+    }
+
+    result.gcd = r1;
+    result.x = x1; result.y = y1;
+    return result;
+}
+
+// Specialise the algorithms of EuclideanAlgorithm.hpp for GF(2) polynomials.
+template<>
+inline GF2Polynomial euclidean<GF2Polynomial>(const GF2Polynomial& a_orig, const GF2Polynomial& b_orig)
+{
+    return gf2_euclidean(a_orig, b_orig);
+}
+
+template<>
+inline EEuclideanResult<GF2Polynomial> extended_euclidean<GF2Polynomial>(const GF2Polynomial& a_orig, const GF2Polynomial& b_orig)
+{
+    // (As the generic extended_euclidean, the result carries the work done for it.)
+#ifdef POLYNOMIAL_INSTRUMENTATION
+    const InstrumentationStats before = Instrumentation::snapshot();
+    EEuclideanResult<GF2Polynomial> result = gf2_extended_euclidean(a_orig, b_orig);
+    result.stats = Instrumentation::stats().since(before);
+    return result;
+#else
+    return gf2_extended_euclidean(a_orig, b_orig);
+#endif
+}
+
+#endif // _GF2_POLYNOMIAL_H
@@ -0,0 +1,208 @@
+#ifndef _HALF_GCD_H
+#define _HALF_GCD_H
+
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include "PolynomialThresholds.hpp"
+#include "EuclideanAlgorithm.hpp"
+#include "Polynomial.hpp"
+#include "PolynomialExpression.hpp"
+
+// The half-GCD algorithm: the extended Euclidean algorithm of polynomials in O(M(n) log n),
+// where M(n) is the cost of a multiplication.
+//
+// The classical algorithm goes through the remainder sequence one division at a time, and every
+// division costs O(n), so the whole sequence costs O(n^2). But the first quotients only depend on the
+// top coefficients of the polynomials: the quotients of (a div x^k, b div x^k) are the same as the
+// ones of (a, b) while the remainders are above x^k. So the steps which halve the degree can be
+// found recursively from the top halves, collected in a 2x2 matrix, and applied to the whole
+// polynomials by a few (fast) multiplications.
+//
+// The result is exactly the one of the classical algorithm: the same remainder sequence is computed,
+// just in larger steps.
+
+// A 2x2 matrix of polynomials, mapping a pair (a, b) of the remainder sequence to a later pair:
+//     [ a' ]   [ m00 m01 ] [ a ]
+//     [ b' ] = [ m10 m11 ] [ b ]
+// The first row holds the Bezout coefficients of a', the second row the ones of b'.
+template<typename P>
+struct RemainderMatrix
+{
+    P m00, m01, m10, m11;
+
+    static RemainderMatrix<P> identity()
+    {
+        RemainderMatrix<P> matrix;
+        matrix.m00 = matrix.m11 = id_multiplicative<P>::value;
+        return matrix;
+    }
+};
+
+// The product of two matrices (the steps of 'right' come first)
+// (Every entry is a sum of two products, accumulated into it in one pass; see PolynomialExpression.hpp.)
+template<typename P>
+RemainderMatrix<P> operator*(const RemainderMatrix<P>& left, const RemainderMatrix<P>& right)
+{
+    Instrumentation::PhaseTimer timer(phase_matrix);
+
+    RemainderMatrix<P> product;
+    assign(product.m00, lazy(left.m00) * right.m00 + lazy(left.m01) * right.m10);
+    assign(product.m01, lazy(left.m00) * right.m01 + lazy(left.m01) * right.m11);
+    assign(product.m10, lazy(left.m10) * right.m00 + lazy(left.m11) * right.m10);
+    assign(product.m11, lazy(left.m10) * right.m01 + lazy(left.m11) * right.m11);
+    return product;
+}
+
+// Number of coefficients of a polynomial (0 for the nullpolynomial)
+template<typename T, typename Storage>
+size_t half_gcd_size(const Polynomial<T, Storage>& p)
+{
+    return p.isNull() ? 0 : p.degree() + 1;
+}
+
+// p div x^k: the coefficients from x^k up, shifted down
+template<typename T, typename Storage>
+Polynomial<T, Storage> half_gcd_shift(const Polynomial<T, Storage>& p, const size_t k)
+{
+    Polynomial<T, Storage> shifted;
+    if (half_gcd_size(p) <= k)
+        return shifted;
+
+    typename Polynomial<T, Storage>::BatchEdit batch(shifted);
+    batch.reserve(p.degree() - k);
+    for (size_t i = k; i <= p.degree(); ++i)
+        batch.setMember(i - k, p.getMember(i));
+
+    return shifted;
+}
+
+// (a, b) = M * (a, b)
+template<typename P>
+void half_gcd_apply(const RemainderMatrix<P>& matrix, P& a, P& b)
+{
+    Instrumentation::PhaseTimer timer(phase_matrix);
+
+    P new_a;
+    assign(new_a, lazy(matrix.m00) * a + lazy(matrix.m01) * b);
+    assign(b, lazy(matrix.m10) * a + lazy(matrix.m11) * b);
+    a = std::move(new_a);
+}
+
+// One step of the classical algorithm: (a, b) = (b, a mod b), and the step is recorded into the matrix.
+// [ 0  1 ]
+// [ 1 -q ] is the matrix of the step, where q is the quotient of a / b.
+template<typename P>
+void half_gcd_step(RemainderMatrix<P>& matrix, P& a, P& b)
+{
+    P q, r;
+    Instrumentation::iteration(b);
+    {
+        Instrumentation::PhaseTimer timer(phase_division);
+        divmod(a, b, q, r);
+    }
+
+    a = std::move(b);
+    b = std::move(r);
+
+    // The new second row is computed in place of the first one, then the rows are exchanged.
+    Instrumentation::PhaseTimer timer(phase_cofactors);
+    submul(matrix.m00, q, matrix.m10);
+    submul(matrix.m01, q, matrix.m11);
+    std::swap(matrix.m00, matrix.m10);
+    std::swap(matrix.m01, matrix.m11);
+}
+
+// The matrix taking (a, b) (deg a >= deg b) to the pair (a', b') of its remainder sequence
+// where b' is the first remainder with less than half as many coefficients as a.
+template<typename P>
+RemainderMatrix<P> half_gcd_reduce(P a, P b)
+{
+    const size_t half = half_gcd_size(a) / 2;
+    if (half_gcd_size(b) <= half)
+        return RemainderMatrix<P>::identity();
+
+    // Small polynomials are reduced by plain division steps.
+    if (a.degree() < polynomial_thresholds::half_gcd)
+    {
+        RemainderMatrix<P> matrix = RemainderMatrix<P>::identity();
+        while (half_gcd_size(b) > half)
+            half_gcd_step(matrix, a, b);
+
+        return matrix;
+    }
+
+    // The top half of the polynomials determines the steps down to about 3/4 of the degree...
+    RemainderMatrix<P> matrix = half_gcd_reduce(half_gcd_shift(a, half), half_gcd_shift(b, half));
+    half_gcd_apply(matrix, a, b);
+    if (half_gcd_size(b) <= half)
+        return matrix;
+
+    half_gcd_step(matrix, a, b);
+    if (half_gcd_size(b) <= half)
+        return matrix;
+
+    // ... and after one more step, the top of what remains determines the steps down to half of it.
+    const size_t shift = 2 * half - a.degree();
+    return half_gcd_reduce(half_gcd_shift(a, shift), half_gcd_shift(b, shift)) * matrix;
+}
+
+// The extended Euclidean algorithm of polynomials using half-GCD reductions. (See EuclideanAlgorithm.hpp.)
+template<typename T, typename Storage>
+EEuclideanResult<Polynomial<T, Storage> > half_gcd_extended_euclidean(const Polynomial<T, Storage>& a_orig, const Polynomial<T, Storage>& b_orig)
+{
+    typedef Polynomial<T, Storage> P;
+
+    P a = a_orig;
+    P b = b_orig;
+    RemainderMatrix<P> matrix = RemainderMatrix<P>::identity();
+
+    // Like the classical algorithm, start with a division, which also orders the pair by degree.
+    half_gcd_step(matrix, a, b);
+
+    while (!b.isNull())
+    {
+        // Halve the degree in one go (the product with the matrix found for it costs a few multiplications),
+        // then take the step which didn't fit into the half.
+        if (b.degree() >= polynomial_thresholds::half_gcd)
+        {
+            const RemainderMatrix<P> reduction = half_gcd_reduce(a, b);
+            half_gcd_apply(reduction, a, b);
+            matrix = reduction * matrix;
+
+            if (b.isNull())
+                break;
+        }
+
+        half_gcd_step(matrix, a, b);
+    }
+
+    // a is the last non-zero remainder: the GCD, and the first row of the matrix holds its Bezout coefficients.
+    EEuclideanResult<P> result;
+    result.a = a_orig; result.b = b_orig;
+    result.gcd = a;
+    result.x = matrix.m00; result.y = matrix.m01;
+    return result;
+}
+
+// Polynomials with fast arithmetic (contiguous storage, coefficients of a field) switch to
+// the half-GCD when both have a large degree.
+// (Not for floating-point coefficients: the half-GCD relies on exact arithmetic. With rounding, the quotients of
+// the top halves are not the ones of the whole polynomials, and the recursion may never get below the half.)
+template<typename T, typename Storage>
+struct extended_euclidean_strategy<Polynomial<T, Storage> >
+{
+    static EEuclideanResult<Polynomial<T, Storage> > compute(const Polynomial<T, Storage>& a, const Polynomial<T, Storage>& b)
+    {
+        if constexpr (Storage::contiguous && !std::is_integral<T>::value && !std::is_floating_point<T>::value)
+        {
+            if (!b.isNull() && std::min(a.degree(), b.degree()) >= polynomial_thresholds::half_gcd)
+                return half_gcd_extended_euclidean(a, b);
+        }
+
+        return classical_extended_euclidean(a, b);
+    }
+};
+
+#endif // _HALF_GCD_H
@@ -0,0 +1,252 @@
+#ifndef _INSTRUMENTATION_H
+#define _INSTRUMENTATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+#ifdef POLYNOMIAL_INSTRUMENTATION
+#include <chrono>
+#endif
+
+// Counters and timers on the hot paths of the polynomial arithmetic, to see where a computation spends its time.
+//
+// Switched on at compile time, by defining POLYNOMIAL_INSTRUMENTATION (for every translation unit of the program).
+// Without it, the hooks are empty and compile to nothing, and the statistics stay empty.
+//
+// The statistics are kept for every thread, and count:
+//  - multiplications, additions: the coefficient operations of the bulk passes: the coefficient kernels
+//    (see SimdKernels.hpp), the number-theoretic transforms, the sparse products and divisions, and Horner's rule.
+//    (Subtractions count as additions. The scalar operations elsewhere are not counted.)
+//  - inversions: the inverses and divisions of the coefficients
+//  - allocations: the buffers (and map nodes) of the storages of the polynomials (see polynomial_allocator)
+//  - normalizations: the normalisation passes of the polynomials
+// and the time of the phases of every iteration of the Euclidean algorithms.
+
+enum instrumentation_phase
+{
+    phase_division,  // The division of an iteration
+    phase_cofactors, // The update of the Bezout coefficients
+    phase_matrix,    // The products of the half-GCD matrices (see HalfGCD.hpp)
+    phase_count
+};
+
+inline const char* instrumentation_phase_name(const instrumentation_phase phase)
+{
+    static const char* const names[phase_count] = { "division", "cofactors", "matrix" };
+    return names[phase];
+}
+
+// An iteration of a Euclidean algorithm
+struct InstrumentationIteration
+{
+    size_t degree; // The degree of the divisor
+    uint64_t phase_nanoseconds[phase_count];
+};
+
+struct InstrumentationStats
+{
+    uint64_t multiplications = 0;
+    uint64_t additions = 0;
+    uint64_t inversions = 0;
+    uint64_t allocations = 0;
+    uint64_t allocated_bytes = 0;
+    uint64_t normalizations = 0;
+
+    // The total time of the phases
+    uint64_t phase_nanoseconds[phase_count] = {};
+
+    // The iterations of the Euclidean algorithms, in order
+    uint64_t euclidean_iterations = 0;
+    std::vector<InstrumentationIteration> iterations;
+
+    // The statistics since an earlier snapshot of the same thread (see Instrumentation::snapshot)
+    InstrumentationStats since(const InstrumentationStats& earlier) const
+    {
+        InstrumentationStats difference;
+        difference.multiplications = this->multiplications - earlier.multiplications;
+        difference.additions = this->additions - earlier.additions;
+        difference.inversions = this->inversions - earlier.inversions;
+        difference.allocations = this->allocations - earlier.allocations;
+        difference.allocated_bytes = this->allocated_bytes - earlier.allocated_bytes;
+        difference.normalizations = this->normalizations - earlier.normalizations;
+        for (size_t i = 0; i < phase_count; ++i)
+            difference.phase_nanoseconds[i] = this->phase_nanoseconds[i] - earlier.phase_nanoseconds[i];
+
+        difference.euclidean_iterations = this->euclidean_iterations - earlier.euclidean_iterations;
+        if (earlier.euclidean_iterations <= this->iterations.size())
+            difference.iterations.assign(this->iterations.begin() + earlier.euclidean_iterations, this->iterations.end());
+
+        return difference;
+    }
+};
+
+class Instrumentation
+{
+    public:
+#ifdef POLYNOMIAL_INSTRUMENTATION
+        static constexpr bool enabled = true;
+#else
+        static constexpr bool enabled = false;
+#endif
+
+        // The statistics of the calling thread
+        static const InstrumentationStats& stats() { return current(); }
+
+        // The counters of the calling thread, without the iterations (to be compared by InstrumentationStats::since)
+        static InstrumentationStats snapshot()
+        {
+            // (The iterations are set aside while copying, so that a snapshot doesn't cost more as they pile up.)
+            InstrumentationStats& stats = current();
+            std::vector<InstrumentationIteration> iterations;
+            iterations.swap(stats.iterations);
+            InstrumentationStats counters = stats;
+            stats.iterations.swap(iterations);
+            return counters;
+        }
+
+        static void reset() { current() = InstrumentationStats(); }
+
+        /* The hooks */
+        static void multiplications(const uint64_t n) { if constexpr (enabled) current().multiplications += n; }
+        static void additions(const uint64_t n) { if constexpr (enabled) current().additions += n; }
+        static void inversions(const uint64_t n) { if constexpr (enabled) current().inversions += n; }
+        static void normalization() { if constexpr (enabled) ++current().normalizations; }
+
+        static void allocation(const size_t bytes)
+        {
+            if constexpr (enabled)
+            {
+                ++current().allocations;
+                current().allocated_bytes += bytes;
+            }
+        }
+
+        // Start an iteration of a Euclidean algorithm dividing by the given divisor:
+        // the phases timed from here on belong to it. (The degree is recorded for polynomials, 0 for other types.)
+        template<typename T>
+        static void iteration(const T& divisor)
+        {
+            if constexpr (enabled)
+            {
+                InstrumentationStats& stats = current();
+                ++stats.euclidean_iterations;
+                stats.iterations.push_back({ degreeOf(divisor, 0), {} });
+            }
+        }
+
+        // Time a phase while the scope lives
+#ifdef POLYNOMIAL_INSTRUMENTATION
+        class PhaseTimer
+        {
+            public:
+                explicit PhaseTimer(const instrumentation_phase phase)
+                    : m_phase(phase), m_start(std::chrono::steady_clock::now()) {}
+
+                ~PhaseTimer()
+                {
+                    const uint64_t elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - this->m_start).count());
+
+                    InstrumentationStats& stats = current();
+                    stats.phase_nanoseconds[this->m_phase] += elapsed;
+                    if (!stats.iterations.empty())
+                        stats.iterations.back().phase_nanoseconds[this->m_phase] += elapsed;
+                }
+
+                PhaseTimer(const PhaseTimer&) = delete;
+                PhaseTimer& operator = (const PhaseTimer&) = delete;
+
+            private:
+                instrumentation_phase m_phase;
+                std::chrono::steady_clock::time_point m_start;
+        };
+#else
+        class PhaseTimer
+        {
+            public:
+                explicit PhaseTimer(const instrumentation_phase) {}
+        };
+#endif
+
+    private:
+        template<typename T>
+        static auto degreeOf(const T& value, int) -> decltype(static_cast<size_t>(value.degree())) { return value.degree(); }
+
+        template<typename T>
+        static size_t degreeOf(const T&, long) { return 0; }
+
+        static InstrumentationStats& current()
+        {
+            static thread_local InstrumentationStats stats;
+            return stats;
+        }
+};
+
+// The statistics as a block of text: the counters, the time of the phases, and a line for every iteration.
+inline std::ostream& operator<<(std::ostream& o, const InstrumentationStats& stats)
+{
+    o << "multiplications: " << stats.multiplications << std::endl;
+    o << "additions: " << stats.additions << std::endl;
+    o << "inversions: " << stats.inversions << std::endl;
+    o << "allocations: " << stats.allocations << " (" << stats.allocated_bytes << " bytes)" << std::endl;
+    o << "normalizations: " << stats.normalizations << std::endl;
+
+    o << "phases:";
+    for (size_t phase = 0; phase < phase_count; ++phase)
+        o << " " << instrumentation_phase_name(static_cast<instrumentation_phase>(phase)) << " " << stats.phase_nanoseconds[phase] << " ns";
+    o << std::endl;
+
+    o << "iterations: " << stats.euclidean_iterations << std::endl;
+    for (size_t i = 0; i < stats.iterations.size(); ++i)
+    {
+        o << "  " << i + 1 << ": degree " << stats.iterations[i].degree << ",";
+        for (size_t phase = 0; phase < phase_count; ++phase)
+            o << " " << instrumentation_phase_name(static_cast<instrumentation_phase>(phase)) << " " << stats.iterations[i].phase_nanoseconds[phase] << " ns";
+        o << std::endl;
+    }
+
+    return o;
+}
+
+// The allocator of the storages of the polynomials by default (see PolynomialStorage.hpp):
+// the standard one, which counts its allocations if the instrumentation is on.
+template<typename T>
+class InstrumentedAllocator
+{
+    public:
+        typedef T value_type;
+
+        InstrumentedAllocator() noexcept {}
+
+        template<typename U>
+        InstrumentedAllocator(const InstrumentedAllocator<U>&) noexcept {}
+
+        T* allocate(const size_t n)
+        {
+            Instrumentation::allocation(n * sizeof(T));
+            return std::allocator<T>().allocate(n);
+        }
+
+        void deallocate(T* pointer, const size_t n) noexcept
+        {
+            std::allocator<T>().deallocate(pointer, n);
+        }
+};
+
+template<typename T, typename U>
+bool operator == (const InstrumentedAllocator<T>&, const InstrumentedAllocator<U>&) { return true; }
+
+template<typename T, typename U>
+bool operator != (const InstrumentedAllocator<T>&, const InstrumentedAllocator<U>&) { return false; }
+
+#ifdef POLYNOMIAL_INSTRUMENTATION
+template<typename T>
+using polynomial_allocator = InstrumentedAllocator<T>;
+#else
+template<typename T>
+using polynomial_allocator = std::allocator<T>;
+#endif
+
+#endif // _INSTRUMENTATION_H
@@ -0,0 +1,91 @@
+#ifndef _MONTGOMERY_H
+#define _MONTGOMERY_H
+
+#include <cstdint>
+
+// Montgomery arithmetic modulo an odd number n < 2^63.
+//
+// Numbers are kept in the Montgomery form a * R (mod n), where R = 2^64. In that form multiplication
+// needs no division: the reduction of a 128-bit product only takes two more multiplications and a shift.
+// Every member function is constexpr, so a modulus known at compile time has all of its constants precomputed.
+class Montgomery64
+{
+    public:
+        constexpr Montgomery64(const uint64_t mod)
+            : m_modulo(mod), m_inverse(negatedInverse(mod)), m_r2(calcR2(mod))
+        {
+        }
+
+        constexpr uint64_t modulo() const { return this->m_modulo; }
+
+        // -n^-1 (mod R), the factor of the reduction (for vectorised versions of it, see SimdKernels.hpp)
+        constexpr uint64_t reductionFactor() const { return this->m_inverse; }
+
+        // Conversion from and to the Montgomery form (the argument of toMontgomery has to be reduced)
+        constexpr uint64_t toMontgomery(const uint64_t a) const { return this->multiply(a, this->m_r2); }
+        constexpr uint64_t fromMontgomery(const uint64_t a) const { return this->reduce(a); }
+
+        // Do +, - and * operation on numbers in Montgomery form
+        constexpr uint64_t add(const uint64_t a, const uint64_t b) const
+        {
+            const uint64_t sum = a + b; // No overflow, as n < 2^63
+            return sum >= this->m_modulo ? sum - this->m_modulo : sum;
+        }
+
+        constexpr uint64_t subtract(const uint64_t a, const uint64_t b) const
+        {
+            return a >= b ? a - b : a + this->m_modulo - b;
+        }
+
+        constexpr uint64_t multiply(const uint64_t a, const uint64_t b) const
+        {
+            return this->reduce(static_cast<unsigned __int128>(a) * b);
+        }
+
+        // a^exponent, for a in Montgomery form
+        constexpr uint64_t power(uint64_t a, uint64_t exponent) const
+        {
+            uint64_t result = this->toMontgomery(1 % this->m_modulo);
+            while (exponent > 0)
+            {
+                if (exponent & 1)
+                    result = this->multiply(result, a);
+                a = this->multiply(a, a);
+                exponent >>= 1;
+            }
+
+            return result;
+        }
+
+    private:
+        uint64_t m_modulo;
+        uint64_t m_inverse; // -n^-1 (mod R)
+        uint64_t m_r2;      // R^2 (mod n)
+
+        // Montgomery reduction: t * R^-1 (mod n), for t < n * R
+        constexpr uint64_t reduce(const unsigned __int128 t) const
+        {
+            // m is chosen so that t + m * n is divisible by R.
+            const uint64_t m = static_cast<uint64_t>(t) * this->m_inverse;
+            const uint64_t result = static_cast<uint64_t>((t + static_cast<unsigned __int128>(m) * this->m_modulo) >> 64);
+            return result >= this->m_modulo ? result - this->m_modulo : result;
+        }
+
+        static constexpr uint64_t negatedInverse(const uint64_t mod)
+        {
+            // Newton's iteration for the inverse modulo 2^64: every step doubles the correct low bits.
+            // (n * n = 1 (mod 8) holds for every odd n, so n is correct on its 3 lowest bits.)
+            uint64_t inverse = mod;
+            for (int i = 0; i < 5; ++i)
+                inverse *= 2 - mod * inverse;
+            return 0 - inverse;
+        }
+
+        static constexpr uint64_t calcR2(const uint64_t mod)
+        {
+            const unsigned __int128 r = (0 - mod) % mod; // 2^64 (mod n)
+            return static_cast<uint64_t>(r * r % mod);
+        }
+};
+
+#endif // _MONTGOMERY_H
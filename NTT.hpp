@@ -0,0 +1,322 @@
+#ifndef _NTT_H
+#define _NTT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include "Montgomery.hpp"
+#include "Instrumentation.hpp"
+
+// Number-theoretic transform (NTT): the discrete Fourier transform over Z_p, for primes p = c * 2^k + 1.
+// Such a field has primitive 2^k-th roots of unity, so products of length up to 2^k can be computed
+// by transforming the operands, multiplying them pointwise and transforming the result back. O(n log n)
+
+// Deterministic Miller-Rabin primality test for numbers below 2^63
+inline bool ntt_is_prime(const uint64_t n)
+{
+    if (n < 2)
+        return false;
+
+    static const uint64_t witnesses[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 };
+    for (uint64_t w : witnesses)
+    {
+        if (n % w == 0)
+            return n == w;
+    }
+
+    // n is odd from now on: n - 1 = d * 2^s
+    uint64_t d = n - 1;
+    unsigned s = 0;
+    while ((d & 1) == 0)
+    {
+        d >>= 1;
+        ++s;
+    }
+
+    const Montgomery64 field(n);
+    const uint64_t one = field.toMontgomery(1);
+    const uint64_t minus_one = field.toMontgomery(n - 1);
+
+    for (uint64_t w : witnesses)
+    {
+        uint64_t x = field.power(field.toMontgomery(w), d);
+        if (x == one || x == minus_one)
+            continue;
+
+        bool composite = true;
+        for (unsigned i = 1; i < s && composite; ++i)
+        {
+            x = field.multiply(x, x);
+            if (x == minus_one)
+                composite = false;
+        }
+
+        if (composite)
+            return false;
+    }
+
+    return true;
+}
+
+// Modular power for small moduli (below 2^32), usable at compile time
+constexpr uint64_t ntt_small_power(uint64_t base, uint64_t exponent, const uint64_t mod)
+{
+    uint64_t result = 1 % mod;
+    base %= mod;
+    while (exponent > 0)
+    {
+        if (exponent & 1)
+            result = result * base % mod;
+        base = base * base % mod;
+        exponent >>= 1;
+    }
+
+    return result;
+}
+
+// A prime field suitable for the transform
+class NTTPrime
+{
+    public:
+        // Check if p is a prime with 2^k-th roots of unity (k > 0), and set up the field for it if so.
+        explicit NTTPrime(const uint64_t p);
+
+        // Is p suitable for the transform
+        bool valid() const { return this->m_twoAdicity > 0; }
+
+        uint64_t modulo() const { return this->m_field.modulo(); }
+
+        // The longest transform this field supports
+        size_t maxLength() const { return size_t(1) << this->m_twoAdicity; }
+
+        // Product of a (n coefficients) and b (m coefficients), reduced modulo p.
+        // The coefficients have to be reduced already, and n + m - 1 must not exceed maxLength().
+        void convolve(const uint64_t* a, const size_t n, const uint64_t* b, const size_t m, uint64_t* out) const;
+
+    private:
+        Montgomery64 m_field;
+        unsigned m_twoAdicity; // k, for p = c * 2^k + 1 (0 if p is not suitable)
+        uint64_t m_root;       // A primitive 2^k-th root of unity (in Montgomery form)
+
+        // In-place transform of a buffer with a power of 2 length, in Montgomery form
+        void transform(std::vector<uint64_t>& a, const bool inverse) const;
+};
+
+inline NTTPrime::NTTPrime(const uint64_t p)
+    : m_field(p | 1), m_twoAdicity(0), m_root(0)
+{
+    // Montgomery arithmetic needs an odd modulus below 2^63, and the 2^k-th roots need an even p - 1.
+    if (p < 3 || p >= (uint64_t(1) << 63) || !ntt_is_prime(p))
+        return;
+
+    unsigned twoAdicity = 0;
+    uint64_t odd = p - 1;
+    while ((odd & 1) == 0)
+    {
+        odd >>= 1;
+        ++twoAdicity;
+    }
+
+    // For a quadratic non-residue g, g^((p - 1) / 2^k) has order exactly 2^k.
+    // (By Euler's criterion, g is a non-residue if g^((p - 1) / 2) = -1.)
+    const Montgomery64& f = this->m_field;
+    const uint64_t minus_one = f.toMontgomery(p - 1);
+    for (uint64_t g = 2; g < p; ++g)
+    {
+        const uint64_t candidate = f.toMontgomery(g);
+        if (f.power(candidate, (p - 1) / 2) == minus_one)
+        {
+            this->m_root = f.power(candidate, odd);
+            this->m_twoAdicity = twoAdicity;
+            break;
+        }
+    }
+}
+
+inline void NTTPrime::transform(std::vector<uint64_t>& a, const bool inverse) const
+{
+    const Montgomery64& f = this->m_field;
+    const size_t n = a.size();
+
+    // Bit-reversal permutation, so that the butterflies can work in place
+    for (size_t i = 1, j = 0; i < n; ++i)
+    {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+
+        if (i < j)
+            std::swap(a[i], a[j]);
+    }
+
+    // The root of unity of order n (its inverse for the backward transform)
+    uint64_t root = this->m_root;
+    for (size_t order = size_t(1) << this->m_twoAdicity; order > n; order >>= 1)
+        root = f.multiply(root, root);
+    if (inverse)
+        root = f.power(root, n - 1);
+
+    std::vector<uint64_t> twiddles(n / 2);
+    for (size_t length = 2; length <= n; length <<= 1)
+    {
+        // Powers of the root of unity of order 'length'
+        const size_t half = length / 2;
+        uint64_t step = root;
+        for (size_t order = n; order > length; order >>= 1)
+            step = f.multiply(step, step);
+
+        twiddles[0] = f.toMontgomery(1);
+        for (size_t j = 1; j < half; ++j)
+            twiddles[j] = f.multiply(twiddles[j - 1], step);
+
+        for (size_t i = 0; i < n; i += length)
+        {
+            uint64_t* low = a.data() + i;
+            uint64_t* high = low + half;
+            for (size_t j = 0; j < half; ++j)
+            {
+                const uint64_t u = low[j];
+                const uint64_t v = f.multiply(high[j], twiddles[j]);
+                low[j] = f.add(u, v);
+                high[j] = f.subtract(u, v);
+            }
+        }
+
+        // (n / 2 butterflies per level)
+        Instrumentation::multiplications(n / 2);
+        Instrumentation::additions(n);
+    }
+
+    if (inverse)
+    {
+        const uint64_t scale = f.power(f.toMontgomery(n % f.modulo()), f.modulo() - 2); // n^-1, by Fermat
+        for (uint64_t& x : a)
+            x = f.multiply(x, scale);
+        Instrumentation::multiplications(n);
+    }
+}
+
+inline void NTTPrime::convolve(const uint64_t* a, const size_t n, const uint64_t* b, const size_t m, uint64_t* out) const
+{
+    const Montgomery64& f = this->m_field;
+    const size_t length = n + m - 1;
+
+    size_t size = 1;
+    while (size < length)
+        size <<= 1;
+
+    std::vector<uint64_t> fa(size, 0);
+    std::vector<uint64_t> fb(size, 0);
+    for (size_t i = 0; i < n; ++i)
+        fa[i] = f.toMontgomery(a[i]);
+    for (size_t i = 0; i < m; ++i)
+        fb[i] = f.toMontgomery(b[i]);
+
+    this->transform(fa, false);
+    this->transform(fb, false);
+    for (size_t i = 0; i < size; ++i)
+        fa[i] = f.multiply(fa[i], fb[i]);
+    Instrumentation::multiplications(size);
+    this->transform(fa, true);
+
+    for (size_t i = 0; i < length; ++i)
+        out[i] = f.fromMontgomery(fa[i]);
+}
+
+// Products modulo an arbitrary modulus M < 2^63.
+//
+// If M itself is a prime suitable for the transform, the product is computed directly over Z_M.
+// Otherwise the exact (unreduced) product is computed modulo three fixed NTT primes, and reconstructed
+// by the Chinese remainder theorem, then reduced modulo M. That works as long as the exact coefficients,
+// at most min(n, m) * (M - 1)^2, are below the product of the three primes (about 2^86).
+class NTTEngine
+{
+    public:
+        explicit NTTEngine(const uint64_t mod) : m_modulo(mod), m_prime(mod) {}
+
+        // Is M a prime suitable for the transform itself
+        bool direct() const { return this->m_prime.valid(); }
+
+        // Product of a (n coefficients) and b (m coefficients) reduced modulo M, into out (n + m - 1 coefficients).
+        // The coefficients have to be reduced already.
+        // Returns false (and doesn't touch out) if the operands are too long for the transform.
+        bool multiply(const uint64_t* a, const size_t n, const uint64_t* b, const size_t m, uint64_t* out) const;
+
+    private:
+        uint64_t m_modulo;
+        NTTPrime m_prime;
+
+        // The primes of the three-prime CRT mode: 119 * 2^23 + 1, 5 * 2^25 + 1, 7 * 2^26 + 1
+        static constexpr uint64_t crt_p1 = 998244353;
+        static constexpr uint64_t crt_p2 = 167772161;
+        static constexpr uint64_t crt_p3 = 469762049;
+
+        static const NTTPrime& crtPrime(const size_t index)
+        {
+            static const NTTPrime primes[3] = { NTTPrime(crt_p1), NTTPrime(crt_p2), NTTPrime(crt_p3) };
+            return primes[index];
+        }
+};
+
+inline bool NTTEngine::multiply(const uint64_t* a, const size_t n, const uint64_t* b, const size_t m, uint64_t* out) const
+{
+    const size_t length = n + m - 1;
+
+    if (this->direct() && length <= this->m_prime.maxLength())
+    {
+        this->m_prime.convolve(a, n, b, m, out);
+        return true;
+    }
+
+    // The exact coefficients must be recoverable from their residues modulo the three primes.
+    typedef unsigned __int128 uint128;
+    const uint128 crt_modulo = uint128(crt_p1) * crt_p2 * crt_p3;
+    const uint128 largest_product = uint128(this->m_modulo - 1) * (this->m_modulo - 1);
+    if (largest_product > 0 && largest_product >= crt_modulo / std::min(n, m))
+        return false;
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        if (length > crtPrime(i).maxLength())
+            return false;
+    }
+
+    std::vector<uint64_t> residues[3];
+    std::vector<uint64_t> a_reduced(n);
+    std::vector<uint64_t> b_reduced(m);
+    for (size_t i = 0; i < 3; ++i)
+    {
+        const NTTPrime& prime = crtPrime(i);
+        for (size_t j = 0; j < n; ++j)
+            a_reduced[j] = a[j] % prime.modulo();
+        for (size_t j = 0; j < m; ++j)
+            b_reduced[j] = b[j] % prime.modulo();
+
+        residues[i].resize(length);
+        prime.convolve(a_reduced.data(), n, b_reduced.data(), m, residues[i].data());
+    }
+
+    // Garner's algorithm: x = r1 + p1 * k2 + p1 * p2 * k3, where every digit k is reduced by its own prime.
+    static constexpr uint64_t p1_inverse = ntt_small_power(crt_p1, crt_p2 - 2, crt_p2);          // p1^-1 (mod p2)
+    static constexpr uint64_t p1p2_inverse = ntt_small_power(crt_p1 * crt_p2, crt_p3 - 2, crt_p3); // (p1 p2)^-1 (mod p3)
+    const uint64_t p1p2 = crt_p1 * crt_p2;
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        const uint64_t r1 = residues[0][i];
+        const uint64_t r2 = residues[1][i];
+        const uint64_t r3 = residues[2][i];
+
+        const uint64_t k2 = (r2 + crt_p2 - r1 % crt_p2) % crt_p2 * p1_inverse % crt_p2;
+        const uint64_t x12 = r1 + crt_p1 * k2; // Below p1 * p2
+        const uint64_t k3 = (r3 + crt_p3 - x12 % crt_p3) % crt_p3 * p1p2_inverse % crt_p3;
+
+        out[i] = static_cast<uint64_t>((x12 + uint128(p1p2) * k3) % this->m_modulo);
+    }
+
+    return true;
+}
+
+#endif // _NTT_H
@@ -8,34 +8,61 @@
 #include <cmath>
 #include <vector>
 #include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
 #include "absvalue_wrapper.hpp"
 #include "add_mult_identity.hpp"
-
-template<typename T>
+#include "inverse_wrapper.hpp"
+#include "PolynomialStorage.hpp"
+#include "Instrumentation.hpp"
+#include "SimdKernels.hpp"
+#include "PolynomialMultiply.hpp"
+#include "PolynomialDivision.hpp"
+
+// Storage is the policy keeping the coefficients (see PolynomialStorage.hpp).
+// By default the coefficients are kept in a dense, degree-indexed buffer.
+template<typename T, typename Storage = DenseStorage<T> >
 class Polynomial
 {
-    typedef std::map<size_t, T, std::greater<size_t> > coefficientsMap;
-
     public:
         /* Constructors */
         // Default constructor
-        Polynomial<T>();
+        Polynomial();
 
         // Constructors for constant polynomials
-        Polynomial<T>(T coefficient);
+        Polynomial(T coefficient);
 
         // Default constructor with initial coefficient length provided
-        //Polynomial<T>(const size_t coefficients);
+        //Polynomial(const size_t coefficients);
 
         // Copy constructor from another polynom
-        Polynomial<T>(const Polynomial<T>& poly);
+        Polynomial(const Polynomial<T, Storage>& poly);
+
+        // Move constructor: takes over the coefficients, leaving the other one as the nullpolynomial
+        Polynomial(Polynomial<T, Storage>&& poly) noexcept;
+
+        // Constructors from a list of coefficients, given from the constant member upwards
+        // (so that the ith element is the coefficient of x^i). The result is normalised once, at the end.
+        Polynomial(std::initializer_list<T> coefficients);
+
+        template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+        Polynomial(InputIt first, InputIt last);
 
         /* Destructor */
-        ~Polynomial<T>();
+        ~Polynomial();
 
         /* Operators */
         // Assignment operator
-        const Polynomial<T>& operator = (const Polynomial<T>& poly);
+        const Polynomial<T, Storage>& operator = (const Polynomial<T, Storage>& poly);
+        const Polynomial<T, Storage>& operator = (Polynomial<T, Storage>&& poly) noexcept;
+
+        // Compound assignment operators, working in place (see add, subtract, multiply and divide)
+        Polynomial<T, Storage>& operator += (const Polynomial<T, Storage>& poly);
+        Polynomial<T, Storage>& operator -= (const Polynomial<T, Storage>& poly);
+        Polynomial<T, Storage>& operator *= (const Polynomial<T, Storage>& poly);
+        Polynomial<T, Storage>& operator /= (const Polynomial<T, Storage>& divisor);
+        Polynomial<T, Storage>& operator %= (const Polynomial<T, Storage>& divisor);
 
         // Subscript getter operator to get an nth coefficient
         T operator [] (const size_t index) const;
@@ -43,39 +70,39 @@ class Polynomial
         T& operator [] (const size_t index);*/
 
         // Arithmetic operators
-        template<typename U>
-        friend Polynomial<U> operator + (const Polynomial<U>& a, const Polynomial<U>& b);
-        template<typename U>
-        friend Polynomial<U> operator - (const Polynomial<U>& a, const Polynomial<U>& b);
+        template<typename U, typename S>
+        friend Polynomial<U, S> operator + (const Polynomial<U, S>& a, const Polynomial<U, S>& b);
+        template<typename U, typename S>
+        friend Polynomial<U, S> operator - (const Polynomial<U, S>& a, const Polynomial<U, S>& b);
 
-        template<typename U>
-        friend Polynomial<U> operator * (const Polynomial<U>& a, const Polynomial<U>& b);
+        template<typename U, typename S>
+        friend Polynomial<U, S> operator * (const Polynomial<U, S>& a, const Polynomial<U, S>& b);
 
-        template<typename U>
-        friend Polynomial<U> operator / (const Polynomial<U>& a, const Polynomial<U>& b);
-        template<typename U>
-        friend Polynomial<U> operator % (const Polynomial<U>& a, const Polynomial<U>& b);
+        template<typename U, typename S>
+        friend Polynomial<U, S> operator / (const Polynomial<U, S>& a, const Polynomial<U, S>& b);
+        template<typename U, typename S>
+        friend Polynomial<U, S> operator % (const Polynomial<U, S>& a, const Polynomial<U, S>& b);
 
         // �qualit�, in�qualit�
-        template<typename U>
-        friend bool operator == (const Polynomial<U>& a, const Polynomial<U>& b);
+        template<typename U, typename S>
+        friend bool operator == (const Polynomial<U, S>& a, const Polynomial<U, S>& b);
 
-        template<typename U>
-        friend bool operator != (const Polynomial<U>& a, const Polynomial<U>& b);
+        template<typename U, typename S>
+        friend bool operator != (const Polynomial<U, S>& a, const Polynomial<U, S>& b);
 
         // Ordering
-        template<typename U>
-        friend bool operator < (const Polynomial<U>& a, const Polynomial<U>& b);
-        template<typename U>
-        friend bool operator <= (const Polynomial<U>& a, const Polynomial<U>& b);
-        template<typename U>
-        friend bool operator > (const Polynomial<U>& a, const Polynomial<U>& b);
-        template<typename U>
-        friend bool operator >= (const Polynomial<U>& a, const Polynomial<U>& b);
+        template<typename U, typename S>
+        friend bool operator < (const Polynomial<U, S>& a, const Polynomial<U, S>& b);
+        template<typename U, typename S>
+        friend bool operator <= (const Polynomial<U, S>& a, const Polynomial<U, S>& b);
+        template<typename U, typename S>
+        friend bool operator > (const Polynomial<U, S>& a, const Polynomial<U, S>& b);
+        template<typename U, typename S>
+        friend bool operator >= (const Polynomial<U, S>& a, const Polynomial<U, S>& b);
 
         // Printing operator
-        template<typename U>
-        friend std::ostream& operator << (std::ostream& o, const Polynomial<U>& poly);
+        template<typename U, typename S>
+        friend std::ostream& operator << (std::ostream& o, const Polynomial<U, S>& poly);
 
         /* Member functions */
         // Get the degree
@@ -93,20 +120,66 @@ class Polynomial
         // Set the nth coefficient
         void setMember(const size_t index, const T coefficient);
 
+        // Get the non-zero members as (power, coefficient) pairs, from the highest power down
+        sparse_terms<T> members() const;
+
+        // Scope to set many coefficients at once.
+        // The members set through it don't normalise the polynomial one by one: it is normalised only once,
+        // when the scope ends. (Until then, the polynomial should not be used for anything else.)
+        class BatchEdit
+        {
+            public:
+                BatchEdit(Polynomial<T, Storage>& poly) : m_polynomial(poly) {}
+                ~BatchEdit() { this->m_polynomial._performCleanup(); }
+
+                BatchEdit(const BatchEdit&) = delete;
+                BatchEdit& operator = (const BatchEdit&) = delete;
+
+                // Make room for the members up to the given power
+                void reserve(const size_t degree)
+                {
+                    if constexpr (Storage::contiguous)
+                        this->m_polynomial.m_coefficients.reserve(degree + 1);
+                }
+
+                // Set the nth coefficient
+                void setMember(const size_t index, const T coefficient)
+                {
+                    this->m_polynomial.m_coefficients.set(index, coefficient);
+                }
+
+                // Add to the nth coefficient
+                void addToMember(const size_t index, const T coefficient)
+                {
+                    Storage& coefficients = this->m_polynomial.m_coefficients;
+                    coefficients.set(index, coefficients.get(index) + coefficient);
+                }
+
+            private:
+                Polynomial<T, Storage>& m_polynomial;
+        };
+
         // Calculate the polynomial function's value for variable 't'
         T at(const T t) const;
 
         // Algebraic derivative (prime)
-        Polynomial<T> derive() const;
+        Polynomial<T, Storage> derive() const;
+
+        // The monic polynomial associated to this one: every coefficient divided by the LC.
+        // (The LC is inverted only once, if T has a known inverse.)
+        Polynomial<T, Storage> monic() const;
 
         // Arithmetical methods
-        void add(const Polynomial<T>& poly);
-        void subtract(const Polynomial<T>& poly);
-        void multiply(const Polynomial<T>& poly);
-        bool divide(const Polynomial<T>& divisor, Polynomial<T>& quotient, Polynomial<T>& remainder) const;
+        void add(const Polynomial<T, Storage>& poly);
+        void subtract(const Polynomial<T, Storage>& poly);
+        void multiply(const Polynomial<T, Storage>& poly);
+        // this = this - q * b, without a temporary for the product (see also submul)
+        void subtractMultiple(const Polynomial<T, Storage>& q, const Polynomial<T, Storage>& b);
+        // (The quotient and the remainder come from the same pass; see also divmod.)
+        bool divide(const Polynomial<T, Storage>& divisor, Polynomial<T, Storage>& quotient, Polynomial<T, Storage>& remainder) const;
 
         // Equalit�
-        bool equals(const Polynomial<T>& poly) const;
+        bool equals(const Polynomial<T, Storage>& poly) const;
 
         // Get if the polynomial is a nullpolynomial (that is: every coefficient is zero)
         bool isNull() const;
@@ -115,24 +188,22 @@ class Polynomial
         // (that is: a number... only one coefficient on the zeroth power, and it is not zero)
         bool isConstant() const;
 
-    private:
-        // Array for coefficients
-        // (First part of the pair is the power of the indeterminate,
-        // the second part is the coefficient.)
-        typename Polynomial<T>::coefficientsMap m_coefficients;
-
-        // Degree of the polynomial
-        size_t m_degree;
+        // The lazily evaluated expressions work on the coefficients (see PolynomialExpression.hpp)
+        template<typename U, typename S>
+        friend struct polynomial_expression_access;
 
-        // Determine if there is an indeterminate of the given power index
-        bool hasMember(const size_t index) const;
+    private:
+        // The coefficients, stored by the storage policy.
+        // The invariant is that the storage is normalised: the highest stored coefficient is not zero,
+        // and so the degree of the storage is the degree of the polynomial.
+        Storage m_coefficients;
 
         // Internal cleanup function.
         void _performCleanup();
 };
 
-template<typename T>
-Polynomial<T>::Polynomial()
+template<typename T, typename Storage>
+Polynomial<T, Storage>::Polynomial()
 {
     //cout << "Polynomial initialized." << endl;
     this->_performCleanup(); // Make the object into default state
@@ -140,34 +211,57 @@ Polynomial<T>::Polynomial()
     // Noop.
 }
 
-template<typename T>
-Polynomial<T>::Polynomial(T coefficient)
+template<typename T, typename Storage>
+Polynomial<T, Storage>::Polynomial(T coefficient)
 {
     //cout << "Polynomial initialized as constant " << coefficient << endl;
     this->setMember(0, coefficient);
-    this->_performCleanup();
 }
 
-/*template<typename T>
-Polynomial<T>::Polynomial(const size_t coefficients)
+/*template<typename T, typename Storage>
+Polynomial<T, Storage>::Polynomial(const size_t coefficients)
 {
     // Ez nem m�k�dik mivel a map-nak nincs alapb�l m�rete.
     //this->m_coefficients.reserve(coefficients);
 }*/
 
-template<typename T>
-Polynomial<T>::Polynomial(const Polynomial<T>& poly)
+template<typename T, typename Storage>
+Polynomial<T, Storage>::Polynomial(const Polynomial<T, Storage>& poly)
 {
     //cout << "Polynomial copied from " << poly << endl;
-    // Copy the map.
+    // Copy the coefficients.
     this->m_coefficients = poly.m_coefficients;
     this->_performCleanup();
 }
 
+template<typename T, typename Storage>
+Polynomial<T, Storage>::Polynomial(Polynomial<T, Storage>&& poly) noexcept
+    : m_coefficients(std::move(poly.m_coefficients))
+{
+    // (The invariant holds for the moved coefficients already.)
+    poly.m_coefficients.clear();
+}
+
+template<typename T, typename Storage>
+Polynomial<T, Storage>::Polynomial(std::initializer_list<T> coefficients)
+    : Polynomial<T, Storage>(coefficients.begin(), coefficients.end())
+{
+}
+
+template<typename T, typename Storage>
+template<typename InputIt, typename>
+Polynomial<T, Storage>::Polynomial(InputIt first, InputIt last)
+{
+    BatchEdit batch(*this);
+
+    for (size_t power = 0; first != last; ++first, ++power)
+        batch.setMember(power, *first);
+}
+
 #include <sstream>
 
-template<typename T>
-Polynomial<T>::~Polynomial()
+template<typename T, typename Storage>
+Polynomial<T, Storage>::~Polynomial()
 {
     /*stringstream ss;
     ss << *this;
@@ -175,34 +269,90 @@ Polynomial<T>::~Polynomial()
     cout << "The polynomial " << ss.str() << " was destructed." << endl;*/
 }
 
-template<typename T>
-const Polynomial<T>& Polynomial<T>::operator=(const Polynomial<T>& poly)
+template<typename T, typename Storage>
+const Polynomial<T, Storage>& Polynomial<T, Storage>::operator=(const Polynomial<T, Storage>& poly)
 {
     this->m_coefficients = poly.m_coefficients;
     this->_performCleanup();
     return *this;
 }
 
-template<typename T>
-T Polynomial<T>::operator[] (const size_t index) const
+template<typename T, typename Storage>
+const Polynomial<T, Storage>& Polynomial<T, Storage>::operator=(Polynomial<T, Storage>&& poly) noexcept
+{
+    if (this != &poly)
+    {
+        this->m_coefficients = std::move(poly.m_coefficients);
+        poly.m_coefficients.clear();
+    }
+
+    return *this;
+}
+
+template<typename T, typename Storage>
+Polynomial<T, Storage>& Polynomial<T, Storage>::operator+=(const Polynomial<T, Storage>& poly)
+{
+    this->add(poly);
+    return *this;
+}
+
+template<typename T, typename Storage>
+Polynomial<T, Storage>& Polynomial<T, Storage>::operator-=(const Polynomial<T, Storage>& poly)
+{
+    this->subtract(poly);
+    return *this;
+}
+
+template<typename T, typename Storage>
+Polynomial<T, Storage>& Polynomial<T, Storage>::operator*=(const Polynomial<T, Storage>& poly)
+{
+    this->multiply(poly);
+    return *this;
+}
+
+template<typename T, typename Storage>
+Polynomial<T, Storage>& Polynomial<T, Storage>::operator/=(const Polynomial<T, Storage>& divisor)
+{
+    // (Like operator /, dividing by the nullpolynomial gives the nullpolynomial.)
+    Polynomial<T, Storage> quotient;
+    Polynomial<T, Storage> remainder;
+    this->divide(divisor, quotient, remainder);
+
+    *this = std::move(quotient);
+    return *this;
+}
+
+template<typename T, typename Storage>
+Polynomial<T, Storage>& Polynomial<T, Storage>::operator%=(const Polynomial<T, Storage>& divisor)
+{
+    // The remainder is computed right into this one. (Like operator %, dividing by the nullpolynomial gives the nullpolynomial.)
+    Polynomial<T, Storage> quotient;
+    if (!this->divide(divisor, quotient, *this))
+        this->m_coefficients.clear();
+
+    return *this;
+}
+
+template<typename T, typename Storage>
+T Polynomial<T, Storage>::operator[] (const size_t index) const
 {
     return getMember(index);
 }
 
-template<typename T>
-bool operator==(const Polynomial<T>& a, const Polynomial<T>& b)
+template<typename T, typename Storage>
+bool operator==(const Polynomial<T, Storage>& a, const Polynomial<T, Storage>& b)
 {
     return a.equals(b);
 }
 
-template<typename T>
-bool operator!=(const Polynomial<T>& a, const Polynomial<T>& b)
+template<typename T, typename Storage>
+bool operator!=(const Polynomial<T, Storage>& a, const Polynomial<T, Storage>& b)
 {
     return !a.equals(b);
 }
 
-template<typename T>
-std::ostream& operator << (std::ostream& o, const Polynomial<T>& poly)
+template<typename T, typename Storage>
+std::ostream& operator << (std::ostream& o, const Polynomial<T, Storage>& poly)
 {
     if (poly.isNull())
         return o << "0";
@@ -210,86 +360,113 @@ std::ostream& operator << (std::ostream& o, const Polynomial<T>& poly)
         return o << poly.getMember(0);
 
     bool firstCoeff = true;
-    for (typename Polynomial<T>::coefficientsMap::const_iterator cit = poly.m_coefficients.cbegin();
-        cit != poly.m_coefficients.cend(); ++cit)
+    // The members with 0 coefficient are omitted by the storage.
+    poly.m_coefficients.forEachTerm([&o, &firstCoeff](const size_t power, const T& coefficient)
     {
-        // cit->first: power
-        // cit->second: coefficient
-
-        // Omit the members with 0 coefficient
-        if (cit->second == id_additive<T>::value) continue;
-
         if (!firstCoeff)
             o << " ";
 
         // Print the signum of the coefficient
         // (so it would neatly look as -5x^2 + 3x - 2)
-        if (cit->second < id_additive<T>::value)
+        if (coefficient < id_additive<T>::value)
             o << "- ";
-        else if (cit->second > id_additive<T>::value && !firstCoeff)
+        else if (coefficient > id_additive<T>::value && !firstCoeff)
             o << "+ ";
 
         // Only print the coefficient if it is not 1. The 1 multiplier as it's multiplicative identity can be omitted.
         // Because of templating, we use a custom implementation here.
         //
         // But this should only happen for the non-constant member...
-        if (cit->first != 0)
+        if (power != 0)
         {
             if (id_multiplicative_exists<T>::value)
             {
-                if (abs_value<T>::known && abs_value<T>::abs(cit->second) != id_multiplicative<T>::value)
-                    o << abs_value<T>::abs(cit->second);
-                else if (!abs_value<T>::known && cit->second != id_multiplicative<T>::value)
-                    o << cit->second;
+                if (abs_value<T>::known && abs_value<T>::abs(coefficient) != id_multiplicative<T>::value)
+                    o << abs_value<T>::abs(coefficient);
+                else if (!abs_value<T>::known && coefficient != id_multiplicative<T>::value)
+                    o << coefficient;
             }
             else
-                o << cit->second;
+                o << coefficient;
         }
         else
         {
             // If the number is negative, print only its absolute value (the - was printed earlier)
-            if (abs_value<T>::known && cit->second < abs_value<T>::abs(cit->second))
-                o << abs_value<T>::abs(cit->second);
+            if (abs_value<T>::known && coefficient < abs_value<T>::abs(coefficient))
+                o << abs_value<T>::abs(coefficient);
             else
-                o << cit->second;
+                o << coefficient;
         }
 
         // Don't print the power for the first-order member and don't print x for the constant member
-        if (cit->first > 1)
-            o << "x^" << cit->first;
-        if (cit->first == 1)
+        if (power > 1)
+            o << "x^" << power;
+        if (power == 1)
             o << "x";
 
         if (firstCoeff) firstCoeff = false;
-    }
+    });
 
     return o;
 }
 
-template<typename T>
-size_t Polynomial<T>::degree() const
+template<typename T, typename Storage>
+size_t Polynomial<T, Storage>::degree() const
 {
-    return this->m_degree;
+    return this->m_coefficients.degree();
 }
 
-template<typename T>
-T Polynomial<T>::getMember(const size_t index) const
+template<typename T, typename Storage>
+T Polynomial<T, Storage>::getMember(const size_t index) const
+{
+    return this->m_coefficients.get(index);
+}
+
+template<typename T, typename Storage>
+void Polynomial<T, Storage>::setMember(const size_t index, const T coefficient)
 {
-    if (this->hasMember(index))
-        return this->m_coefficients.at(index);
+    // Setting a member can only break the invariant locally, so there is no need for a whole cleanup:
+    // the zero coefficients are just not stored.
+    if (coefficient == id_additive<T>::value)
+        this->m_coefficients.erase(index);
     else
-        return id_additive<T>::value; // Non-existant members are just not stored: they are mathematically there with 0 coefficient.
+        this->m_coefficients.set(index, coefficient); // Add or reassign a member
 }
 
-template<typename T>
-void Polynomial<T>::setMember(const size_t index, const T coefficient)
+template<typename T, typename Storage>
+sparse_terms<T> Polynomial<T, Storage>::members() const
 {
-    this->m_coefficients[index] = coefficient; // Add or reassign a member
-    this->_performCleanup();
+    sparse_terms<T> result;
+    this->m_coefficients.forEachTerm([&result](const size_t power, const T& coefficient)
+    {
+        result.emplace_back(power, coefficient);
+    });
+
+    return result;
 }
 
+/* Helper function to multiply a value by itself n times (n >= 1). */
 template<typename T>
-T Polynomial<T>::at(const T t) const
+T repeated_product(const T& value, size_t n)
+{
+    // Square-and-multiply from the highest bit of n down, so that this takes O(log n) multiplications.
+    size_t bit = 1;
+    while (bit <= n / 2)
+        bit <<= 1;
+
+    T result = value;
+    for (bit >>= 1; bit > 0; bit >>= 1)
+    {
+        result = result * result;
+        if (n & bit)
+            result = result * value;
+    }
+
+    return result;
+}
+
+template<typename T, typename Storage>
+T Polynomial<T, Storage>::at(const T t) const
 {
     // Using Horner's rule:
     // Consider the polynomial x^4 - 3x^3 + 0x^2 - x + 6 at -1.
@@ -304,45 +481,113 @@ T Polynomial<T>::at(const T t) const
 
     T result = this->leadingCoefficient();
 
-    //                                                 V have to make sure we don't underflow.
-    for (size_t power = this->degree() - 1; power >= 0 && power <= this->degree(); --power)
-        result = result * t + this->getMember(power);
+    if constexpr (Storage::contiguous)
+    {
+        // The buffer holds every member, so we can walk it down from the LC without lookups.
+        const T* coefficients = this->m_coefficients.data();
+        for (size_t power = this->degree(); power-- > 0; )
+            result = result * t + coefficients[power];
+
+        Instrumentation::multiplications(this->degree());
+        Instrumentation::additions(this->degree());
+    }
+    else
+    {
+        // Only the stored members are visited: the steps over the missing ones are taken at once,
+        // by multiplying with the power of t of the gap.
+        size_t previous = this->degree();
+        this->m_coefficients.forEachTerm([&result, &previous, &t](const size_t power, const T& coefficient)
+        {
+            if (power == previous) return; // The LC
+
+            result = result * repeated_product(t, previous - power) + coefficient;
+            previous = power;
+
+            Instrumentation::multiplications(1);
+            Instrumentation::additions(1);
+        });
+
+        if (previous > 0)
+            result = result * repeated_product(t, previous);
+    }
 
     return result;
 }
 
+/* Helper function to add a value to itself n times, for types we can't multiply by an integer. */
 template<typename T>
-Polynomial<T> Polynomial<T>::derive() const
+T repeated_sum(const T& value, size_t n)
+{
+    // Double-and-add, so that this takes O(log n) additions instead of n.
+    T result = id_additive<T>::value;
+    T power = value;
+
+    while (n > 0)
+    {
+        if (n & 1)
+            result = result + power;
+
+        n >>= 1;
+        if (n > 0)
+            power = power + power;
+    }
+
+    return result;
+}
+
+template<typename T, typename Storage>
+Polynomial<T, Storage> Polynomial<T, Storage>::derive() const
 {
     if (this->isNull() || this->isConstant())
-        return Polynomial<T>();
+        return Polynomial<T, Storage>();
 
     // If we consider the polynomial as f0 + f1x + f2x^2 + ..., the
     //  algebraic derivative (prime) is f1 + 2*f2x + 3*f3x^2 + ...
     // (Where 2*f2 actually means f2 + f2, as f2 is just a variable of type T)
-    Polynomial<T> derivative;
-    for (size_t power = 0; power < this->degree(); ++power)
+    Polynomial<T, Storage> derivative;
     {
-        // The i-th coefficient of the derivate is (i + 1)* the (i+1)th coefficient
-        T curr_coeff = this->getMember(power + 1);
+        BatchEdit batch(derivative);
+        batch.reserve(this->degree() - 1);
 
-        // Don't run the loop for coefficients which are 0
-        if (curr_coeff == id_additive<T>::value) continue;
+        this->m_coefficients.forEachTerm([&batch](const size_t power, const T& coefficient)
+        {
+            // The constant part is eaten by the prime.
+            if (power == 0) return;
 
-        for (size_t i = 1; i < power + 1; ++i)
-            curr_coeff += this->getMember(power + 1);
+            // The i-th coefficient of the derivate is (i + 1)* the (i+1)th coefficient
+            batch.setMember(power - 1, repeated_sum(coefficient, power));
+        });
+    }
 
-        derivative.setMember(power, curr_coeff);
+    return derivative;
+}
 
-        // The coefficient for the degree-th member is zero, the prime "eats" that part.
-        // Also, the constant part is eaten too.
+template<typename T, typename Storage>
+Polynomial<T, Storage> Polynomial<T, Storage>::monic() const
+{
+    if (this->isNull())
+        return Polynomial<T, Storage>();
+
+    const InverseCache<T> lc(this->leadingCoefficient());
+
+    Polynomial<T, Storage> result;
+    {
+        BatchEdit batch(result);
+        batch.reserve(this->degree());
+
+        this->m_coefficients.forEachTerm([&batch, &lc](const size_t power, const T& coefficient)
+        {
+            batch.setMember(power, lc.divide(coefficient));
+        });
     }
 
-    return derivative;
+    // (The LC becomes exactly 1, even if T rounds.)
+    result.setMember(this->degree(), id_multiplicative<T>::value);
+    return result;
 }
 
-template<typename T>
-void Polynomial<T>::add(const Polynomial<T>& poly)
+template<typename T, typename Storage>
+void Polynomial<T, Storage>::add(const Polynomial<T, Storage>& poly)
 {
     //          2x^2 + 3x + 1
     // (+) x^3 + x^2 - 2x - 2
@@ -351,20 +596,51 @@ void Polynomial<T>::add(const Polynomial<T>& poly)
     //
     // So we have to member-by-member add the coefficients to get the added polynomial
 
-    for (size_t p = 0; p <= std::max(this->degree(), poly.degree()); ++p)
-        this->setMember(p, this->getMember(p) + poly.getMember(p));
+    if constexpr (Storage::contiguous)
+    {
+        if (this->m_coefficients.size() < poly.m_coefficients.size())
+            this->m_coefficients.resize(poly.m_coefficients.size());
+
+        // Member-by-member, by the fastest kernel known for T (see SimdKernels.hpp)
+        coefficient_kernels<T>::add(this->m_coefficients.data(), poly.m_coefficients.data(), poly.m_coefficients.size());
+    }
+    else
+    {
+        // Only the members stored in the other polynomial change anything.
+        poly.m_coefficients.forEachTerm([this](const size_t power, const T& coefficient)
+        {
+            this->m_coefficients.set(power, this->m_coefficients.get(power) + coefficient);
+        });
+    }
+
+    // The leading coefficients might have cancelled out each other.
+    this->_performCleanup();
 }
 
-template<typename T>
-void Polynomial<T>::subtract(const Polynomial<T>& poly)
+template<typename T, typename Storage>
+void Polynomial<T, Storage>::subtract(const Polynomial<T, Storage>& poly)
 {
     // Subtraction works just as so
-    for (size_t p = 0; p <= std::max(this->degree(), poly.degree()); ++p)
-        this->setMember(p, this->getMember(p) - poly.getMember(p));
+    if constexpr (Storage::contiguous)
+    {
+        if (this->m_coefficients.size() < poly.m_coefficients.size())
+            this->m_coefficients.resize(poly.m_coefficients.size());
+
+        coefficient_kernels<T>::subtract(this->m_coefficients.data(), poly.m_coefficients.data(), poly.m_coefficients.size());
+    }
+    else
+    {
+        poly.m_coefficients.forEachTerm([this](const size_t power, const T& coefficient)
+        {
+            this->m_coefficients.set(power, this->m_coefficients.get(power) - coefficient);
+        });
+    }
+
+    this->_performCleanup();
 }
 
-template<typename T>
-void Polynomial<T>::multiply(const Polynomial<T>& poly)
+template<typename T, typename Storage>
+void Polynomial<T, Storage>::multiply(const Polynomial<T, Storage>& poly)
 {
     // If either is a nullpolynomial, the multiple is trivially a nullpolynomial
     if (this->isNull() || poly.isNull())
@@ -383,119 +659,234 @@ void Polynomial<T>::multiply(const Polynomial<T>& poly)
         // Select which polynomial is the constant and the more complex one;
         const Polynomial* constantOne = (this->isConstant() ? this : &poly);
         const Polynomial* complexOne = (!this->isConstant() ? this : &poly);
-        Polynomial<T> multiple;
 
         // Only multiply the coefficients of the complex polynomial by the given constant, storing it in this
         T constant = constantOne->leadingCoefficient();
-        for (size_t i = 0; i <= complexOne->degree(); ++i)
+        if constexpr (Storage::contiguous)
         {
-            T coeff = complexOne->getMember(i);
-            if (coeff == id_additive<T>::value) continue;
+            if (complexOne != this)
+                this->m_coefficients = complexOne->m_coefficients;
 
-            multiple.setMember(i, coeff * constant);
+            coefficient_kernels<T>::scale(this->m_coefficients.data(), this->m_coefficients.size(), constant);
         }
+        else
+        {
+            Storage multiple;
+            complexOne->m_coefficients.forEachTerm([&multiple, &constant](const size_t power, const T& coeff)
+            {
+                multiple.set(power, coeff * constant);
+            });
 
-        // Let the multiplied polynomial be the current one
-        *this = multiple;
+            // Let the multiplied polynomial be the current one
+            this->m_coefficients = multiple;
+        }
+
+        // (The multiple of non-zero coefficients can still be zero in rings with zero divisors.)
+        this->_performCleanup();
     }
     // If both polynomials are complex ones, we do the multiplication by hand
     else
     {
-        std::vector<T> multi_coefficients;
-        multi_coefficients.resize(this->degree() + poly.degree() + 1); // Create space for the coefficients
-
-        for (size_t i = 0; i <= this->degree(); ++i)
+        if constexpr (Storage::contiguous)
         {
-            T left = this->getMember(i);
-            if (left == id_additive<T>::value) continue; // 0 * anything = 0
+            typename Storage::buffer multi_coefficients;
+            multi_coefficients.resize(this->degree() + poly.degree() + 1, id_additive<T>::value); // Create space for the coefficients
+
+            // Basically you have to multiply every member with every member...
+            // which is done by the fastest engine known for T (see PolynomialMultiply.hpp).
+            polynomial_multiplier<T>::multiply(this->m_coefficients.data(), this->m_coefficients.size(),
+                poly.m_coefficients.data(), poly.m_coefficients.size(), multi_coefficients.data());
 
-            for (size_t j = 0; j <= poly.degree(); ++j)
+            // The calculated buffer becomes the coefficients
+            this->m_coefficients.swap(multi_coefficients);
+        }
+        else
+        {
+            // Only the stored (non-zero) members have to be multiplied with each other: their products are
+            // merged by power (see PolynomialMultiply.hpp), so neither the time nor the memory depends on the degree.
+            const sparse_terms<T> left = this->members();
+            const sparse_terms<T> right = poly.members();
+
+            // The members of the product come from the highest power down, just in the order of the storage.
+            Storage multiple;
+            sparse_heap_multiply(left, right, [&multiple](const size_t power, const T& coefficient)
             {
-                T right = poly.getMember(j);
-                if (right == id_additive<T>::value) continue; // anything * 0 = 0
+                multiple.append(power, coefficient);
+            });
+
+            this->m_coefficients = std::move(multiple);
+        }
+
+        this->_performCleanup();
+    }
+}
+
+template<typename T, typename Storage>
+void Polynomial<T, Storage>::subtractMultiple(const Polynomial<T, Storage>& q, const Polynomial<T, Storage>& b)
+{
+    if (q.isNull() || b.isNull())
+        return;
+
+    // The operands are read while this one is written.
+    if (this == &q || this == &b)
+    {
+        this->subtract(q * b);
+        return;
+    }
+
+    if constexpr (Storage::contiguous)
+    {
+        const size_t product_size = q.m_coefficients.size() + b.m_coefficients.size() - 1;
+        if (this->m_coefficients.size() < product_size)
+            this->m_coefficients.resize(product_size);
 
-                // Basically you have to multiply every member with every member...
-                multi_coefficients.at(i+j) += left * right;
+        const Storage& shorter = (q.m_coefficients.size() <= b.m_coefficients.size() ? q.m_coefficients : b.m_coefficients);
+        const Storage& longer = (&shorter == &q.m_coefficients ? b.m_coefficients : q.m_coefficients);
+        T* rest = this->m_coefficients.data();
+
+        if (shorter.size() <= polynomial_thresholds::karatsuba)
+        {
+            // Schoolbook: the longer one, scaled by every member of the shorter one, is subtracted at its power.
+            // (Like a step of the Euclidean algorithm, where the quotient usually has only a few members.)
+            for (size_t i = 0; i < shorter.size(); ++i)
+            {
+                const T member = shorter.data()[i];
+                if (member != id_additive<T>::value)
+                    coefficient_kernels<T>::axpy(rest + i, longer.data(), longer.size(), id_additive<T>::value - member);
             }
         }
+        else
+        {
+            // The product of long operands is computed by the fastest engine known for T (see PolynomialMultiply.hpp).
+            typename Storage::buffer product(product_size, id_additive<T>::value);
+            polynomial_multiplier<T>::multiply(q.m_coefficients.data(), q.m_coefficients.size(),
+                b.m_coefficients.data(), b.m_coefficients.size(), product.data());
 
-        // Set the calculated coefficients
-        this->m_coefficients.clear();
-        for (size_t i = 0; i < multi_coefficients.size(); ++i)
-            this->setMember(i, multi_coefficients.at(i));
+            coefficient_kernels<T>::subtract(rest, product.data(), product_size);
+        }
+    }
+    else
+    {
+        // Every pair of stored members changes a single member of this one.
+        Storage& rest = this->m_coefficients;
+        q.m_coefficients.forEachTerm([&rest, &b](const size_t q_power, const T& q_coefficient)
+        {
+            b.m_coefficients.forEachTerm([&rest, &q_power, &q_coefficient](const size_t b_power, const T& b_coefficient)
+            {
+                const size_t target = q_power + b_power;
+                const T difference = rest.get(target) - q_coefficient * b_coefficient;
+                Instrumentation::multiplications(1);
+                Instrumentation::additions(1);
+                if (difference == id_additive<T>::value)
+                    rest.erase(target);
+                else
+                    rest.set(target, difference);
+            });
+        });
     }
+
+    this->_performCleanup();
 }
 
-template<typename T>
-bool Polynomial<T>::divide(const Polynomial<T>& divisor, Polynomial<T>& quotient, Polynomial<T>& remainder) const
+template<typename T, typename Storage>
+bool Polynomial<T, Storage>::divide(const Polynomial<T, Storage>& divisor, Polynomial<T, Storage>& quotient, Polynomial<T, Storage>& remainder) const
 {
     if (divisor.isNull())
         return false;
 
-    if (divisor.degree() > this->degree())
+    // The divisor is needed until the very end, so it must not be overwritten by the results.
+    if (&divisor == &quotient || &divisor == &remainder)
+    {
+        const Polynomial<T, Storage> divisor_copy = divisor;
+        return this->divide(divisor_copy, quotient, remainder);
+    }
+
+    // (The nullpolynomial has no members to divide: 0 = 0 * divisor + 0.)
+    if (divisor.degree() > this->degree() || this->isNull())
     {
         remainder = *this;
-        Polynomial<T> quotient_null;
-        quotient = quotient_null;
+        quotient.m_coefficients.clear();
         return true;
     }
-    else
+
     // Degree of divisor is smaller or equal than divident
+    // f : g = q
+    // f % g = r
+    // f: dividend (this), g: divisor, q: quotient, r: remainder
+    // The remainder is only initially 'this', it gets consumed in place as the division happens:
+    // each member of the quotient is the quotient of the LCs, and the divisor multiplied by that member
+    // (that is: scaled, and shifted by its power) is subtracted from the top of the remainder.
+    const size_t divisor_degree = divisor.degree();
+    const size_t quotient_size = this->degree() - divisor_degree + 1;
+
+    if constexpr (Storage::contiguous)
     {
-        Polynomial dividend = *this; // Save out the current instance
-        // f : g = q
-        // f % g = r
-        // f: dividend (this), g: divisor, q: quotient, r: remainder
-        // The dividend is only initially 'this', it gets consumed as the division happens.
-
-        size_t quotient_max_degree = dividend.degree() - divisor.degree();
-        size_t quotient_member_degree = quotient_max_degree;
-        // We can only divide further if there is something to divide.
-        while (quotient_member_degree >= 0 && quotient_member_degree <= quotient_max_degree && !dividend.isNull())
-        {
-            /*cout << "-----------------------------" << endl;
-            cout << "I'm running a division loop. Current degree of the quotient: " << quotient_member_degree << endl;
-            cout << "(Maximum plausible degree of quotient: " << quotient_max_degree << ")" << endl;
-            cout << "Dividend: " << dividend << endl;*/
-            // Subtract the divisor's LC from the dividend's LC
-            // (and so the powers), so that we get the LC of the quotient.
-            /*cout << "deg(divident) = " << dividend.degree() << endl;
-            cout << "lc(dividend) = " << dividend.leadingCoefficient() << endl;*/
-
-            // After subtracting the LCs, we get the quotient's LC.
-            // Using polynomial long division, we now multiply the quotient's LC by the divisor (-> getting a polynomial)
-            // and thus, we subtract that from the dividend... and loop this whole shit.)
+        // A sparse divisor (like a trinomial) is subtracted only where it has members.
+        std::vector<size_t> divisor_powers;
+        const bool sparse_divisor = sparse_divisor_powers(divisor.m_coefficients.data(), divisor.m_coefficients.size(), divisor_powers);
 
-            // If the current member degree underflows, thus reaches a values higher than the maximum degree
-            // We terminate the whole cycle because we reached the remainder.
-            if (quotient_member_degree > quotient_max_degree)
-                break;
-
-            // Set the current member of the quotient to the quotient of the coefficients
-            quotient.setMember(quotient_member_degree, dividend.leadingCoefficient() / divisor.leadingCoefficient());
+        if (!sparse_divisor && use_newton_division<T>(quotient_size, divisor.m_coefficients.size(), divisor.leadingCoefficient()))
+        {
+            // Long quotients are computed from the reciprocal of the divisor (see PolynomialDivision.hpp).
+            typename Storage::buffer quotient_coefficients;
+            typename Storage::buffer remainder_coefficients;
+            newton_divide(this->m_coefficients.data(), this->m_coefficients.size(),
+                divisor.m_coefficients.data(), divisor.m_coefficients.size(), quotient_coefficients, remainder_coefficients);
+
+            quotient.m_coefficients.swap(quotient_coefficients);
+            quotient._performCleanup();
+            remainder.m_coefficients.swap(remainder_coefficients);
+            remainder._performCleanup();
+            return true;
+        }
 
-            Polynomial<T> multiplier;
-            multiplier.setMember(quotient_member_degree, quotient.getMember(quotient_member_degree));
+        // (Assigning the buffers keeps the capacity of the results, so reused results don't allocate.)
+        remainder.m_coefficients = this->m_coefficients;
+        quotient.m_coefficients.clear();
+        quotient.m_coefficients.resize(quotient_size);
 
-            /*cout << "Divisor: " << divisor << endl;*/
-            Polynomial<T> inner_multiple = divisor * multiplier;
+        long_divide(remainder.m_coefficients.data(), remainder.m_coefficients.size(),
+            divisor.m_coefficients.data(), divisor.m_coefficients.size(), sparse_divisor, divisor_powers,
+            quotient.m_coefficients.data());
+    }
+    else
+    {
+        const InverseCache<T> divisor_lc(divisor.leadingCoefficient());
 
-            dividend = dividend - inner_multiple;
+        remainder = *this;
+        quotient.m_coefficients.clear();
 
-            /*cout << "Current quotient (across division operation): " << quotient << endl;
-            cout << "Current multiplier: " << multiplier << endl;
-            cout << "Multiplied dividend: (this will be subtracted) " << inner_multiple << endl;
-            cout << "New dividend (after subtraction): " << dividend << endl;*/
+        Storage& rest = remainder.m_coefficients;
+        while (!remainder.isNull() && remainder.degree() >= divisor_degree)
+        {
+            const size_t quotient_member_degree = remainder.degree() - divisor_degree;
+            const T member = divisor_lc.divide(remainder.leadingCoefficient());
+            quotient.m_coefficients.set(quotient_member_degree, member);
 
-            quotient_member_degree = dividend.degree() - divisor.degree();
+            // Only the members of the remainder where the divisor has a member change.
+            divisor.m_coefficients.forEachTerm([&rest, &member, &quotient_member_degree](const size_t power, const T& coefficient)
+            {
+                const size_t target = power + quotient_member_degree;
+                const T difference = rest.get(target) - member * coefficient;
+                Instrumentation::multiplications(1);
+                Instrumentation::additions(1);
+                if (difference == id_additive<T>::value)
+                    rest.erase(target);
+                else
+                    rest.set(target, difference);
+            });
+
+            // The LC of the remainder is eliminated by the construction of the member (even if T rounds).
+            rest.erase(quotient_member_degree + divisor_degree);
         }
+    }
 
-        // When the loop reaches its terminus, we divided everything we could.
-        // Anything that remained in the dividend (after subtraction) is actually the remainder.
-        remainder = dividend; // So assign it into its proper place.
+    // When the loop reaches its terminus, we divided everything we could.
+    // Anything that remained (after subtraction) is actually the remainder.
+    quotient._performCleanup();
+    remainder._performCleanup();
 
-        return true;
-    }
+    return true;
 }
 
 /* Helper functions to equate two values... needed for floating-point arithmetics. */
@@ -520,8 +911,8 @@ template<> bool equate(const double& a, const double& b) { return float_equate(a
 template<> bool equate(const long double& a, const long double& b) { return float_equate(a, b, (long double)LDBL_EPSILON); }
 /* Helper functions over. */
 
-template<typename T>
-bool Polynomial<T>::equals(const Polynomial<T>& poly) const
+template<typename T, typename Storage>
+bool Polynomial<T, Storage>::equals(const Polynomial<T, Storage>& poly) const
 {
     // Two polynomials are equal if their degree is equal and every coefficient is equal for every member.
     /* We could do it this way, but it's safer if we check without assuming the invariant for now...
@@ -533,148 +924,190 @@ bool Polynomial<T>::equals(const Polynomial<T>& poly) const
     if (this->degree() != poly.degree())
         return false;
 
-    bool is_equal = true; // Assume that it is equal
-    for (size_t i = 0; i <= this->degree() && is_equal == true; ++i) // The sizes are now equal
-        is_equal &= equate(this->getMember(i), poly.getMember(i));
+    if constexpr (Storage::contiguous)
+    {
+        bool is_equal = true; // Assume that it is equal
+        for (size_t i = 0; i <= this->degree() && is_equal == true; ++i) // The sizes are now equal
+            is_equal &= equate(this->getMember(i), poly.getMember(i));
+
+        return is_equal;
+    }
+    else
+    {
+        // Only the stored members are compared, walking both from the highest power down.
+        // (A member stored in only one of them is compared with 0.)
+        const sparse_terms<T> left = this->members();
+        const sparse_terms<T> right = poly.members();
 
-    return is_equal;
+        size_t i = 0, j = 0;
+        while (i < left.size() || j < right.size())
+        {
+            if (j == right.size() || (i < left.size() && left[i].first > right[j].first))
+            {
+                if (!equate(left[i++].second, id_additive<T>::value))
+                    return false;
+            }
+            else if (i == left.size() || right[j].first > left[i].first)
+            {
+                if (!equate(id_additive<T>::value, right[j++].second))
+                    return false;
+            }
+            else if (!equate(left[i++].second, right[j++].second))
+                return false;
+        }
+
+        return true;
+    }
 }
 
-template<typename T>
-bool Polynomial<T>::isNull() const
+template<typename T, typename Storage>
+bool Polynomial<T, Storage>::isNull() const
 {
     // A polynomial is a null-polynomial if every coefficient is zero.
     // Utilising the invariant, if we are nullpolynomial, the degree is zero and that 0th coefficient is zero.
     return (this->degree() == 0 && this->getMember(0) == id_additive<T>::value);
 }
 
-template<typename T>
-bool Polynomial<T>::isConstant() const
+template<typename T, typename Storage>
+bool Polynomial<T, Storage>::isConstant() const
 {
     // The polynomial is a constant one if there is only a constant (0th power) member
     return (this->degree() == 0 && this->getMember(0) != id_additive<T>::value);
 }
 
-template<typename T>
-void Polynomial<T>::_performCleanup()
+template<typename T, typename Storage>
+void Polynomial<T, Storage>::_performCleanup()
 {
-    // Cleanup consists of removing the 0 coefficient parts from the map
-    std::vector<size_t> removePowers;
-    removePowers.reserve(this->m_coefficients.size());
-
-    // And keeping the degree of the object the degree of the polynomial
-    size_t maxPower = 0;
-
-    // Get the 0 coefficient elements from the map
-    for (typename Polynomial<T>::coefficientsMap::const_iterator cit = this->m_coefficients.cbegin();
-        cit != this->m_coefficients.cend(); ++cit)
-    {
-        if (cit->second == id_additive<T>::value)
-            removePowers.push_back(cit->first);
-        else
-            if (cit->first > maxPower)
-                maxPower = cit->first;
-    }
-
-    // Remove the elements
-    for (std::vector<size_t>::const_iterator cit = removePowers.cbegin(); cit != removePowers.cend(); ++cit)
-        this->m_coefficients.erase(*cit);
-
-    this->m_degree = maxPower;
-}
-
-template<typename T>
-bool Polynomial<T>::hasMember(const size_t index) const
-{
-    // This is basically the standard way of finding if the given power exists
-    // The iterator becomes the end of the collection if the value is not found
-    return this->m_coefficients.find(index) != this->m_coefficients.end();
+    // Cleanup consists of removing the 0 coefficient parts from the storage,
+    // so that the degree of the storage is the degree of the polynomial.
+    this->m_coefficients.normalize();
+    Instrumentation::normalization();
 }
 
-template<typename T>
-Polynomial<T> operator+(const Polynomial<T>& a, const Polynomial<T>& b)
+template<typename T, typename Storage>
+Polynomial<T, Storage> operator+(const Polynomial<T, Storage>& a, const Polynomial<T, Storage>& b)
 {
-    Polynomial<T> ret = a;
+    Polynomial<T, Storage> ret = a;
     ret.add(b);
 
     return ret;
 }
 
-template<typename T>
-Polynomial<T> operator-(const Polynomial<T>& a, const Polynomial<T>& b)
+template<typename T, typename Storage>
+Polynomial<T, Storage> operator-(const Polynomial<T, Storage>& a, const Polynomial<T, Storage>& b)
 {
-    Polynomial<T> ret = a;
+    Polynomial<T, Storage> ret = a;
     ret.subtract(b);
 
     return ret;
 }
 
-template<typename T>
-Polynomial<T> operator*(const Polynomial<T>& a, const Polynomial<T>& b)
+template<typename T, typename Storage>
+Polynomial<T, Storage> operator*(const Polynomial<T, Storage>& a, const Polynomial<T, Storage>& b)
 {
-    Polynomial<T> ret = a;
+    Polynomial<T, Storage> ret = a;
     ret.multiply(b);
 
     return ret;
 }
 
-template<typename T>
-Polynomial<T> operator/(const Polynomial<T>& a, const Polynomial<T>& b)
+// The left operand is a temporary (like in a * b + c): its coefficients become the result, instead of a copy.
+template<typename T, typename Storage>
+Polynomial<T, Storage> operator+(Polynomial<T, Storage>&& a, const Polynomial<T, Storage>& b)
+{
+    a.add(b);
+    return std::move(a);
+}
+
+template<typename T, typename Storage>
+Polynomial<T, Storage> operator-(Polynomial<T, Storage>&& a, const Polynomial<T, Storage>& b)
+{
+    a.subtract(b);
+    return std::move(a);
+}
+
+template<typename T, typename Storage>
+Polynomial<T, Storage> operator*(Polynomial<T, Storage>&& a, const Polynomial<T, Storage>& b)
 {
-    Polynomial<T> q; // quotient
-    Polynomial<T> r; // remainder
+    a.multiply(b);
+    return std::move(a);
+}
+
+template<typename T, typename Storage>
+Polynomial<T, Storage> operator/(const Polynomial<T, Storage>& a, const Polynomial<T, Storage>& b)
+{
+    Polynomial<T, Storage> q; // quotient
+    Polynomial<T, Storage> r; // remainder
 
     a.divide(b, q, r);
 
     return q;
 }
 
-template<typename T>
-Polynomial<T> operator%(const Polynomial<T>& a, const Polynomial<T>& b)
+template<typename T, typename Storage>
+Polynomial<T, Storage> operator%(const Polynomial<T, Storage>& a, const Polynomial<T, Storage>& b)
 {
-    Polynomial<T> q; // quotient
-    Polynomial<T> r; // remainder
+    Polynomial<T, Storage> q; // quotient
+    Polynomial<T, Storage> r; // remainder
 
     a.divide(b, q, r);
 
     return r;
 }
 
+// Quotient and remainder of a / b at once: one pass of the division instead of one for each operator.
+// (Overloads the generic version of EuclideanAlgorithm.hpp.)
+template<typename T, typename Storage>
+void divmod(const Polynomial<T, Storage>& a, const Polynomial<T, Storage>& b, Polynomial<T, Storage>& quotient, Polynomial<T, Storage>& remainder)
+{
+    a.divide(b, quotient, remainder);
+}
+
+// a = a - q * b in place. (Overloads the generic version of EuclideanAlgorithm.hpp.)
+template<typename T, typename Storage>
+void submul(Polynomial<T, Storage>& a, const Polynomial<T, Storage>& q, const Polynomial<T, Storage>& b)
+{
+    a.subtractMultiple(q, b);
+}
+
 // The 'phi' functions of polynomials (in the Euclidean ring order) is their degree
-template<typename T>
-bool operator<(const Polynomial<T>& a, const Polynomial<T>& b)
+template<typename T, typename Storage>
+bool operator<(const Polynomial<T, Storage>& a, const Polynomial<T, Storage>& b)
 {
     return a.degree() < b.degree();
 }
 
-template<typename T>
-bool operator<=(const Polynomial<T>& a, const Polynomial<T>& b)
+template<typename T, typename Storage>
+bool operator<=(const Polynomial<T, Storage>& a, const Polynomial<T, Storage>& b)
 {
     return a.degree() <= b.degree();
 }
 
-template<typename T>
-bool operator>(const Polynomial<T>& a, const Polynomial<T>& b)
+template<typename T, typename Storage>
+bool operator>(const Polynomial<T, Storage>& a, const Polynomial<T, Storage>& b)
 {
     return a.degree() > b.degree();
 }
 
-template<typename T>
-bool operator>=(const Polynomial<T>& a, const Polynomial<T>& b)
+template<typename T, typename Storage>
+bool operator>=(const Polynomial<T, Storage>& a, const Polynomial<T, Storage>& b)
 {
-    return a.degree >= b.degree();
+    return a.degree() >= b.degree();
 }
 
 #ifdef _ADD_MULT_IDENTITY_H
 // The additive and multiplicative identity of a polynomial of type T is
 // a constant polynomial with LC of add/mult id of type T.
-template<typename T> struct id_multiplicative_exists<Polynomial<T>> : id_multiplicative_exists<T>{};
-template<typename T> struct id_multiplicative<Polynomial<T>> { static Polynomial<T> const value; };
-template<typename T> Polynomial<T> const id_multiplicative<Polynomial<T>>::value = Polynomial<T>(id_multiplicative<T>::value);
+template<typename T, typename Storage> struct id_multiplicative_exists<Polynomial<T, Storage>> : id_multiplicative_exists<T>{};
+template<typename T, typename Storage> struct id_multiplicative<Polynomial<T, Storage>> { static Polynomial<T, Storage> const value; };
+template<typename T, typename Storage> Polynomial<T, Storage> const id_multiplicative<Polynomial<T, Storage>>::value = Polynomial<T, Storage>(id_multiplicative<T>::value);
 
-template<typename T> struct id_additive_exists<Polynomial<T>> : id_additive_exists<T>{};
-template<typename T> struct id_additive<Polynomial<T>> { static Polynomial<T> const value; };
-template<typename T> Polynomial<T> const id_additive<Polynomial<T>>::value = Polynomial<T>(id_additive<T>::value);
+template<typename T, typename Storage> struct id_additive_exists<Polynomial<T, Storage>> : id_additive_exists<T>{};
+template<typename T, typename Storage> struct id_additive<Polynomial<T, Storage>> { static Polynomial<T, Storage> const value; };
+template<typename T, typename Storage> Polynomial<T, Storage> const id_additive<Polynomial<T, Storage>>::value = Polynomial<T, Storage>(id_additive<T>::value);
 #endif // _ADD_MULT_IDENTITY_H
 
+// The extended Euclidean algorithm of polynomials of large degree goes by the half-GCD.
+#include "HalfGCD.hpp"
+
 #endif // _POLYNOMIAL_H
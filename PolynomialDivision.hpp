@@ -0,0 +1,180 @@
+#ifndef _POLYNOMIAL_DIVISION_H
+#define _POLYNOMIAL_DIVISION_H
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include "add_mult_identity.hpp"
+#include "inverse_wrapper.hpp"
+#include "PolynomialThresholds.hpp"
+#include "PolynomialMultiply.hpp"
+
+// Fast division kernels for contiguous coefficient buffers (the ith element is the coefficient of x^i).
+//
+// Dividing f (n coefficients) by g (m coefficients) gives a quotient q of n - m + 1 coefficients.
+// Reversing the order of the coefficients (rev(f)(x) = x^(n-1) f(1/x)) turns f = q * g + r into
+//     rev(f) = rev(q) * rev(g)  (mod x^(n-m+1)),
+// so rev(q) = rev(f) * rev(g)^-1, where the reciprocal of the power series rev(g) is computed by
+// Newton's iteration. Every step doubles the correct coefficients, so with fast multiplication
+// underneath the whole division costs a few multiplications instead of O((n - m) * m).
+
+// Should a division with the given quotient and divisor lengths use the Newton reciprocal
+template<typename T>
+bool use_newton_division(const size_t quotient_size, const size_t divisor_size)
+{
+    // The reciprocal needs the inverse of the divisor's LC, which integral types don't have.
+    if (std::is_integral<T>::value)
+        return false;
+
+    return std::min(quotient_size, divisor_size) >= polynomial_thresholds::newton_division;
+}
+
+// The same for a divisor with the given LC: the reciprocal also needs the LC to be invertible
+// (which the residues modulo a composite number are not always).
+template<typename T>
+bool use_newton_division(const size_t quotient_size, const size_t divisor_size, const T& divisor_lc)
+{
+    if (!use_newton_division<T>(quotient_size, divisor_size))
+        return false;
+
+    if constexpr (multiplicative_inverse<T>::known)
+        return InverseCache<T>(divisor_lc).invertible();
+    return true;
+}
+
+// The powers of the non-zero members of g (m coefficients) below its LC, if g is sparse enough
+// for the long division to subtract it member by member (see polynomial_thresholds::sparse_division).
+template<typename T>
+bool sparse_divisor_powers(const T* g, const size_t m, std::vector<size_t>& powers)
+{
+    powers.clear();
+    for (size_t i = 0; i + 1 < m; ++i)
+    {
+        if (g[i] == id_additive<T>::value) continue;
+
+        if (powers.size() == polynomial_thresholds::sparse_division)
+            return false;
+        powers.push_back(i);
+    }
+
+    return 4 * powers.size() <= m;
+}
+
+// The long division of rest (n coefficients, divided in place) by b (m coefficients, n >= m, non-zero LC):
+// each member of the quotient is the quotient of the LCs, and b multiplied by that member (that is: scaled,
+// and shifted by its power) is subtracted from the top of rest. The n - m + 1 members of the quotient are
+// written to quotient (which has to be zeroed); the remainder is left in the lowest m - 1 coefficients of rest,
+// and the ones above are zeroed. If b is sparse (see sparse_divisor_powers), it is subtracted only where it
+// has members.
+template<typename T>
+void long_divide(T* rest, const size_t n, const T* b, const size_t m, const bool sparse_divisor,
+    const std::vector<size_t>& divisor_powers, T* quotient)
+{
+    // Every member of the quotient is divided by the LC of the divisor: it is inverted only once.
+    const InverseCache<T> divisor_lc(b[m - 1]);
+    const size_t divisor_degree = m - 1;
+
+    for (size_t quotient_member_degree = n - m + 1; quotient_member_degree-- > 0; )
+    {
+        T* window = rest + quotient_member_degree;
+        if (window[divisor_degree] == id_additive<T>::value) continue; // This member of the quotient is 0
+
+        const T member = divisor_lc.divide(window[divisor_degree]);
+        quotient[quotient_member_degree] = member;
+
+        // window = window - member * divisor, below the LC
+        if (sparse_divisor)
+        {
+            for (const size_t power : divisor_powers)
+                window[power] = window[power] - member * b[power];
+
+            Instrumentation::multiplications(divisor_powers.size());
+            Instrumentation::additions(divisor_powers.size());
+        }
+        else
+            coefficient_kernels<T>::axpy(window, b, divisor_degree, id_additive<T>::value - member);
+
+        // The LC of the remainder is eliminated by the construction of the member (even if T rounds).
+        window[divisor_degree] = id_additive<T>::value;
+    }
+}
+
+// The reciprocal g of the power series f (n coefficients) modulo x^k, that is f * g = 1 (mod x^k).
+// The constant member of f has to be invertible.
+template<typename T>
+void newton_reciprocal(const T* f, const size_t n, const size_t k, std::vector<T>& g)
+{
+    g.assign(1, InverseCache<T>(f[0]).divide(id_multiplicative<T>::value));
+
+    std::vector<T> product;
+    std::vector<T> error;
+    std::vector<T> correction;
+    for (size_t precision = 1; precision < k; )
+    {
+        // If g is correct modulo x^p, then g + g * (1 - f * g) is correct modulo x^2p.
+        const size_t next = std::min(2 * precision, k);
+        const size_t f_size = std::min(n, next);
+
+        product.resize(f_size + g.size() - 1);
+        polynomial_multiplier<T>::multiply(f, f_size, g.data(), g.size(), product.data());
+        product.resize(next, id_additive<T>::value);
+
+        // 1 - f * g is divisible by x^p, so only its members from x^p up to x^2p are needed.
+        error.resize(next - precision);
+        for (size_t i = 0; i < error.size(); ++i)
+            error[i] = id_additive<T>::value - product[precision + i];
+
+        correction.resize(g.size() + error.size() - 1);
+        polynomial_multiplier<T>::multiply(g.data(), g.size(), error.data(), error.size(), correction.data());
+
+        // g has no members above x^p yet, so the correction just extends it.
+        g.resize(next);
+        for (size_t i = precision; i < next; ++i)
+            g[i] = correction[i - precision];
+
+        precision = next;
+    }
+}
+
+// Divide a (n coefficients) by b (m coefficients, n >= m, with an invertible LC) using the Newton reciprocal.
+// The quotient gets n - m + 1, the remainder m - 1 coefficients (neither is normalised).
+// (Buffer is a vector of T, of any allocator.)
+template<typename T, typename Buffer>
+void newton_divide(const T* a, const size_t n, const T* b, const size_t m, Buffer& quotient, Buffer& remainder)
+{
+    const size_t quotient_size = n - m + 1;
+
+    // Only the top coefficients of the operands take part in rev(q) = rev(a) * rev(b)^-1 (mod x^(n-m+1)).
+    const size_t b_used = std::min(m, quotient_size);
+    std::vector<T> reversed_b(b_used);
+    for (size_t i = 0; i < b_used; ++i)
+        reversed_b[i] = b[m - 1 - i];
+
+    std::vector<T> reversed_a(quotient_size);
+    for (size_t i = 0; i < quotient_size; ++i)
+        reversed_a[i] = a[n - 1 - i];
+
+    std::vector<T> reciprocal;
+    newton_reciprocal(reversed_b.data(), b_used, quotient_size, reciprocal);
+
+    std::vector<T> reversed_q(2 * quotient_size - 1);
+    polynomial_multiplier<T>::multiply(reversed_a.data(), quotient_size, reciprocal.data(), quotient_size, reversed_q.data());
+
+    quotient.resize(quotient_size);
+    for (size_t i = 0; i < quotient_size; ++i)
+        quotient[i] = reversed_q[quotient_size - 1 - i];
+
+    // r = a - q * b, which only has members below x^(m-1).
+    remainder.resize(m - 1);
+    if (m > 1)
+    {
+        std::vector<T> product(n);
+        polynomial_multiplier<T>::multiply(quotient.data(), quotient_size, b, m, product.data());
+
+        for (size_t i = 0; i < m - 1; ++i)
+            remainder[i] = a[i] - product[i];
+    }
+}
+
+#endif // _POLYNOMIAL_DIVISION_H
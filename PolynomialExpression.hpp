@@ -0,0 +1,348 @@
+#ifndef _POLYNOMIAL_EXPRESSION_H
+#define _POLYNOMIAL_EXPRESSION_H
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include "add_mult_identity.hpp"
+#include "PolynomialThresholds.hpp"
+#include "PolynomialMultiply.hpp"
+#include "SimdKernels.hpp"
+#include "Polynomial.hpp"
+
+// Lazily evaluated polynomial arithmetic (expression templates), for polynomials with contiguous storage.
+//
+// The operators of Polynomial<> build a whole polynomial at every step: x0 - q * x1 allocates the product,
+// then a copy of x0 to subtract it from. Wrapping an operand into lazy() makes the operators build
+// a tree of the expression instead, which is computed by assign() in one pass, right into the buffer
+// of the destination:
+//     assign(x0, lazy(x0) - lazy(q) * x1);
+// Every member of the tree is added to (or subtracted from) the destination by the coefficient kernels
+// (see SimdKernels.hpp): a product is a multiply-accumulate (the longer operand is added scaled by every member
+// of the shorter one), which needs no buffer for the product unless it is long enough for a faster
+// multiplication. If the destination is the first operand of a sum (like x0 above), the rest is accumulated
+// onto it in place; if it appears anywhere else, the result is computed into a new buffer first.
+//
+// The expressions refer to their operands, so they have to be assigned within the statement they are built in.
+
+// The expressions work on the coefficients of the polynomials.
+template<typename T, typename Storage>
+struct polynomial_expression_access
+{
+    static const Storage& coefficients(const Polynomial<T, Storage>& poly) { return poly.m_coefficients; }
+    static Storage& coefficients(Polynomial<T, Storage>& poly) { return poly.m_coefficients; }
+
+    static void normalize(Polynomial<T, Storage>& poly) { poly._performCleanup(); }
+};
+
+// Every node of an expression derives from PolynomialExpression<Node, T, Storage>, and offers:
+//  - size():                 the number of coefficients of the result (at most; the top ones may be 0)
+//  - accumulate(out, neg):   out += result (out -= result if neg), on size() coefficients of out
+//  - references(p):          whether the polynomial p is an operand of the expression
+//  - lead():                 the polynomial which is the first operand of the sum (or nullptr)
+//  - accumulateTail(out, neg), tailReferences(p): the same without the lead
+//  - coefficients(buffer):   the coefficients of the result, computed into the buffer if needed
+template<typename Node, typename T, typename Storage>
+class PolynomialExpression
+{
+    public:
+        const Node& node() const { return static_cast<const Node&>(*this); }
+
+        // Evaluate the expression into a new polynomial
+        operator Polynomial<T, Storage>() const { return this->evaluate(); }
+        Polynomial<T, Storage> evaluate() const;
+
+        const T* coefficients(std::vector<T>& buffer) const
+        {
+            buffer.assign(this->node().size(), id_additive<T>::value);
+            this->node().accumulate(buffer.data(), false);
+            return buffer.data();
+        }
+};
+
+// A polynomial operand
+template<typename T, typename Storage>
+class PolynomialTerm : public PolynomialExpression<PolynomialTerm<T, Storage>, T, Storage>
+{
+    public:
+        static_assert(Storage::contiguous, "The expressions work on the buffer of the coefficients");
+
+        explicit PolynomialTerm(const Polynomial<T, Storage>& poly) : m_polynomial(poly) {}
+
+        size_t size() const { return this->storage().size(); }
+
+        void accumulate(T* out, const bool negate) const
+        {
+            if (negate)
+                coefficient_kernels<T>::subtract(out, this->storage().data(), this->size());
+            else
+                coefficient_kernels<T>::add(out, this->storage().data(), this->size());
+        }
+
+        bool references(const Polynomial<T, Storage>& poly) const { return &poly == &this->m_polynomial; }
+
+        const Polynomial<T, Storage>* lead() const { return &this->m_polynomial; }
+        void accumulateTail(T*, const bool) const {}
+        bool tailReferences(const Polynomial<T, Storage>&) const { return false; }
+
+        // (No copy: the buffer of the polynomial itself.)
+        const T* coefficients(std::vector<T>&) const { return this->storage().data(); }
+
+    private:
+        const Polynomial<T, Storage>& m_polynomial;
+
+        const Storage& storage() const { return polynomial_expression_access<T, Storage>::coefficients(this->m_polynomial); }
+};
+
+// left + right, or left - right
+template<typename Left, typename Right, bool Subtract, typename T, typename Storage>
+class PolynomialSum : public PolynomialExpression<PolynomialSum<Left, Right, Subtract, T, Storage>, T, Storage>
+{
+    public:
+        PolynomialSum(const Left& left, const Right& right) : m_left(left), m_right(right) {}
+
+        size_t size() const { return std::max(this->m_left.size(), this->m_right.size()); }
+
+        void accumulate(T* out, const bool negate) const
+        {
+            this->m_left.accumulate(out, negate);
+            this->m_right.accumulate(out, negate != Subtract);
+        }
+
+        bool references(const Polynomial<T, Storage>& poly) const
+        {
+            return this->m_left.references(poly) || this->m_right.references(poly);
+        }
+
+        const Polynomial<T, Storage>* lead() const { return this->m_left.lead(); }
+
+        void accumulateTail(T* out, const bool negate) const
+        {
+            this->m_left.accumulateTail(out, negate);
+            this->m_right.accumulate(out, negate != Subtract);
+        }
+
+        bool tailReferences(const Polynomial<T, Storage>& poly) const
+        {
+            return this->m_left.tailReferences(poly) || this->m_right.references(poly);
+        }
+
+    private:
+        Left m_left;
+        Right m_right;
+};
+
+// left * right
+template<typename Left, typename Right, typename T, typename Storage>
+class PolynomialProduct : public PolynomialExpression<PolynomialProduct<Left, Right, T, Storage>, T, Storage>
+{
+    public:
+        PolynomialProduct(const Left& left, const Right& right) : m_left(left), m_right(right) {}
+
+        size_t size() const
+        {
+            const size_t left_size = this->m_left.size(), right_size = this->m_right.size();
+            return (left_size == 0 || right_size == 0) ? 0 : left_size + right_size - 1;
+        }
+
+        void accumulate(T* out, const bool negate) const
+        {
+            const size_t left_size = this->m_left.size(), right_size = this->m_right.size();
+            if (left_size == 0 || right_size == 0)
+                return;
+
+            std::vector<T> left_buffer, right_buffer;
+            const T* left = this->m_left.coefficients(left_buffer);
+            const T* right = this->m_right.coefficients(right_buffer);
+
+            const bool left_shorter = left_size <= right_size;
+            const T* shorter = left_shorter ? left : right;
+            const T* longer = left_shorter ? right : left;
+            const size_t shorter_size = std::min(left_size, right_size);
+            const size_t longer_size = std::max(left_size, right_size);
+
+            if (shorter_size <= polynomial_thresholds::karatsuba)
+            {
+                // Multiply-accumulate: the longer one, scaled by every member of the shorter one, at its power.
+                for (size_t i = 0; i < shorter_size; ++i)
+                {
+                    if (shorter[i] == id_additive<T>::value)
+                        continue;
+
+                    const T factor = negate ? id_additive<T>::value - shorter[i] : shorter[i];
+                    coefficient_kernels<T>::axpy(out + i, longer, longer_size, factor);
+                }
+            }
+            else
+            {
+                // Long operands are multiplied by the fastest engine known for T (see PolynomialMultiply.hpp).
+                std::vector<T> product(left_size + right_size - 1, id_additive<T>::value);
+                polynomial_multiplier<T>::multiply(left, left_size, right, right_size, product.data());
+
+                if (negate)
+                    coefficient_kernels<T>::subtract(out, product.data(), product.size());
+                else
+                    coefficient_kernels<T>::add(out, product.data(), product.size());
+            }
+        }
+
+        bool references(const Polynomial<T, Storage>& poly) const
+        {
+            return this->m_left.references(poly) || this->m_right.references(poly);
+        }
+
+        const Polynomial<T, Storage>* lead() const { return nullptr; }
+        void accumulateTail(T* out, const bool negate) const { this->accumulate(out, negate); }
+        bool tailReferences(const Polynomial<T, Storage>& poly) const { return this->references(poly); }
+
+    private:
+        Left m_left;
+        Right m_right;
+};
+
+// factor * operand, for a constant factor
+template<typename Operand, typename T, typename Storage>
+class PolynomialScaled : public PolynomialExpression<PolynomialScaled<Operand, T, Storage>, T, Storage>
+{
+    public:
+        PolynomialScaled(const T& factor, const Operand& operand) : m_factor(factor), m_operand(operand) {}
+
+        size_t size() const { return this->m_operand.size(); }
+
+        void accumulate(T* out, const bool negate) const
+        {
+            std::vector<T> buffer;
+            const T* coefficients = this->m_operand.coefficients(buffer);
+
+            const T factor = negate ? id_additive<T>::value - this->m_factor : this->m_factor;
+            coefficient_kernels<T>::axpy(out, coefficients, this->size(), factor);
+        }
+
+        bool references(const Polynomial<T, Storage>& poly) const { return this->m_operand.references(poly); }
+
+        const Polynomial<T, Storage>* lead() const { return nullptr; }
+        void accumulateTail(T* out, const bool negate) const { this->accumulate(out, negate); }
+        bool tailReferences(const Polynomial<T, Storage>& poly) const { return this->references(poly); }
+
+    private:
+        T m_factor;
+        Operand m_operand;
+};
+
+// Start an expression from a polynomial
+template<typename T, typename Storage>
+PolynomialTerm<T, Storage> lazy(const Polynomial<T, Storage>& poly)
+{
+    return PolynomialTerm<T, Storage>(poly);
+}
+
+// destination = expression, computed in one pass into the buffer of the destination.
+template<typename T, typename Storage, typename Node>
+void assign(Polynomial<T, Storage>& destination, const PolynomialExpression<Node, T, Storage>& expression)
+{
+    const Node& node = expression.node();
+    Storage& coefficients = polynomial_expression_access<T, Storage>::coefficients(destination);
+    const size_t size = node.size();
+
+    if (node.lead() == &destination && !node.tailReferences(destination))
+    {
+        // destination = destination + ...: the rest is accumulated onto it.
+        if (coefficients.size() < size)
+            coefficients.resize(size);
+
+        node.accumulateTail(coefficients.data(), false);
+    }
+    else if (!node.references(destination))
+    {
+        // (Clearing keeps the capacity, so reused destinations don't allocate.)
+        coefficients.clear();
+        coefficients.resize(size);
+        node.accumulate(coefficients.data(), false);
+    }
+    else
+    {
+        // The destination is read while the result is computed.
+        typename Storage::buffer result(size, id_additive<T>::value);
+        node.accumulate(result.data(), false);
+        coefficients.swap(result);
+    }
+
+    polynomial_expression_access<T, Storage>::normalize(destination);
+}
+
+template<typename Node, typename T, typename Storage>
+Polynomial<T, Storage> PolynomialExpression<Node, T, Storage>::evaluate() const
+{
+    Polynomial<T, Storage> result;
+    assign(result, *this);
+    return result;
+}
+
+// The operators building the expressions: between expressions, or an expression and a polynomial.
+template<typename L, typename R, typename T, typename S>
+PolynomialSum<L, R, false, T, S> operator+(const PolynomialExpression<L, T, S>& a, const PolynomialExpression<R, T, S>& b)
+{
+    return PolynomialSum<L, R, false, T, S>(a.node(), b.node());
+}
+
+template<typename L, typename T, typename S>
+PolynomialSum<L, PolynomialTerm<T, S>, false, T, S> operator+(const PolynomialExpression<L, T, S>& a, const Polynomial<T, S>& b)
+{
+    return PolynomialSum<L, PolynomialTerm<T, S>, false, T, S>(a.node(), lazy(b));
+}
+
+template<typename R, typename T, typename S>
+PolynomialSum<PolynomialTerm<T, S>, R, false, T, S> operator+(const Polynomial<T, S>& a, const PolynomialExpression<R, T, S>& b)
+{
+    return PolynomialSum<PolynomialTerm<T, S>, R, false, T, S>(lazy(a), b.node());
+}
+
+template<typename L, typename R, typename T, typename S>
+PolynomialSum<L, R, true, T, S> operator-(const PolynomialExpression<L, T, S>& a, const PolynomialExpression<R, T, S>& b)
+{
+    return PolynomialSum<L, R, true, T, S>(a.node(), b.node());
+}
+
+template<typename L, typename T, typename S>
+PolynomialSum<L, PolynomialTerm<T, S>, true, T, S> operator-(const PolynomialExpression<L, T, S>& a, const Polynomial<T, S>& b)
+{
+    return PolynomialSum<L, PolynomialTerm<T, S>, true, T, S>(a.node(), lazy(b));
+}
+
+template<typename R, typename T, typename S>
+PolynomialSum<PolynomialTerm<T, S>, R, true, T, S> operator-(const Polynomial<T, S>& a, const PolynomialExpression<R, T, S>& b)
+{
+    return PolynomialSum<PolynomialTerm<T, S>, R, true, T, S>(lazy(a), b.node());
+}
+
+template<typename L, typename R, typename T, typename S>
+PolynomialProduct<L, R, T, S> operator*(const PolynomialExpression<L, T, S>& a, const PolynomialExpression<R, T, S>& b)
+{
+    return PolynomialProduct<L, R, T, S>(a.node(), b.node());
+}
+
+template<typename L, typename T, typename S>
+PolynomialProduct<L, PolynomialTerm<T, S>, T, S> operator*(const PolynomialExpression<L, T, S>& a, const Polynomial<T, S>& b)
+{
+    return PolynomialProduct<L, PolynomialTerm<T, S>, T, S>(a.node(), lazy(b));
+}
+
+template<typename R, typename T, typename S>
+PolynomialProduct<PolynomialTerm<T, S>, R, T, S> operator*(const Polynomial<T, S>& a, const PolynomialExpression<R, T, S>& b)
+{
+    return PolynomialProduct<PolynomialTerm<T, S>, R, T, S>(lazy(a), b.node());
+}
+
+template<typename E, typename T, typename S>
+PolynomialScaled<E, T, S> operator*(const T& factor, const PolynomialExpression<E, T, S>& a)
+{
+    return PolynomialScaled<E, T, S>(factor, a.node());
+}
+
+template<typename E, typename T, typename S>
+PolynomialScaled<E, T, S> operator*(const PolynomialExpression<E, T, S>& a, const T& factor)
+{
+    return PolynomialScaled<E, T, S>(factor, a.node());
+}
+
+#endif // _POLYNOMIAL_EXPRESSION_H
@@ -0,0 +1,231 @@
+#ifndef _POLYNOMIAL_MULTIPLY_H
+#define _POLYNOMIAL_MULTIPLY_H
+
+#include <cstddef>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include "add_mult_identity.hpp"
+#include "PolynomialThresholds.hpp"
+#include "SimdKernels.hpp"
+
+// Multiplication kernels for contiguous coefficient buffers.
+// Every buffer holds the coefficient of x^i at its ith element, and a product of
+// operands with n and m coefficients has n + m - 1 coefficients.
+//
+// The kernels only use the +, - and * operators of T (through the element-wise coefficient_kernels<T>,
+// see SimdKernels.hpp), and id_additive<T> for the zero, so they work over any coefficient ring.
+
+// The schoolbook method: every member is multiplied with every member. O(n * m)
+// (out has to have room for n + m - 1 coefficients, which are overwritten)
+template<typename T>
+void schoolbook_multiply(const T* a, const size_t n, const T* b, const size_t m, T* out)
+{
+    std::fill(out, out + n + m - 1, id_additive<T>::value);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (a[i] == id_additive<T>::value) continue; // 0 * anything = 0
+
+        coefficient_kernels<T>::axpy(out + i, b, m, a[i]);
+    }
+}
+
+// Size of the scratch space needed by karatsuba_multiply_balanced for operands of n coefficients.
+inline size_t karatsuba_scratch_size(size_t n)
+{
+    size_t size = 0;
+    while (n > polynomial_thresholds::karatsuba && n > 1)
+    {
+        // The two sums of the halves and their product on every level of the recursion
+        const size_t high = n - n / 2;
+        size += 2 * high + (2 * high - 1);
+        n = high;
+    }
+
+    return size;
+}
+
+// Karatsuba's method for operands of equal length n. O(n^1.585)
+// (out has to have room for 2n - 1 coefficients, scratch for karatsuba_scratch_size(n))
+template<typename T>
+void karatsuba_multiply_balanced(const T* a, const T* b, const size_t n, T* out, T* scratch)
+{
+    if (n <= polynomial_thresholds::karatsuba || n == 1)
+    {
+        schoolbook_multiply(a, n, b, n, out);
+        return;
+    }
+
+    // Split both operands into a low and a high half: a = a0 + a1 * x^low, b = b0 + b1 * x^low.
+    // Then a * b = a0b0 + ((a0 + a1)(b0 + b1) - a0b0 - a1b1) * x^low + a1b1 * x^2low,
+    // which takes three products of half the size instead of four.
+    const size_t low = n / 2;
+    const size_t high = n - low;
+
+    // a0b0 goes to the bottom, a1b1 to the top of the output, they don't overlap.
+    karatsuba_multiply_balanced(a, b, low, out, scratch);
+    out[2 * low - 1] = id_additive<T>::value;
+    karatsuba_multiply_balanced(a + low, b + low, high, out + 2 * low, scratch);
+
+    T* a_sum = scratch;
+    T* b_sum = a_sum + high;
+    T* middle = b_sum + high;
+    T* rest = middle + (2 * high - 1);
+
+    for (size_t i = 0; i < high; ++i)
+    {
+        a_sum[i] = (i < low ? a[i] + a[low + i] : a[low + i]);
+        b_sum[i] = (i < low ? b[i] + b[low + i] : b[low + i]);
+    }
+
+    karatsuba_multiply_balanced(a_sum, b_sum, high, middle, rest);
+
+    coefficient_kernels<T>::subtract(middle, out, 2 * low - 1);
+    coefficient_kernels<T>::subtract(middle, out + 2 * low, 2 * high - 1);
+    coefficient_kernels<T>::add(out + low, middle, 2 * high - 1);
+}
+
+// Karatsuba's method for operands of any length.
+// (out has to have room for n + m - 1 coefficients, which are overwritten)
+template<typename T>
+void karatsuba_multiply(const T* a, size_t n, const T* b, size_t m, T* out)
+{
+    // Let a be the longer operand
+    if (n < m)
+    {
+        std::swap(a, b);
+        std::swap(n, m);
+    }
+
+    if (m <= polynomial_thresholds::karatsuba)
+    {
+        schoolbook_multiply(a, n, b, m, out);
+        return;
+    }
+
+    if (m <= n / 2)
+    {
+        // Very unbalanced operands: multiply b with every m-long chunk of a, and add them up with the right shift.
+        std::fill(out, out + n + m - 1, id_additive<T>::value);
+
+        std::vector<T> chunk(m, id_additive<T>::value);
+        std::vector<T> product(2 * m - 1);
+        std::vector<T> scratch(karatsuba_scratch_size(m));
+        for (size_t offset = 0; offset < n; offset += m)
+        {
+            const size_t length = std::min(m, n - offset);
+            std::copy(a + offset, a + offset + length, chunk.begin());
+            std::fill(chunk.begin() + length, chunk.end(), id_additive<T>::value);
+
+            karatsuba_multiply_balanced(chunk.data(), b, m, product.data(), scratch.data());
+
+            coefficient_kernels<T>::add(out + offset, product.data(), length + m - 1);
+        }
+    }
+    else
+    {
+        // Nearly balanced operands: pad b with zeros to the length of a.
+        std::vector<T> padded(b, b + m);
+        padded.resize(n, id_additive<T>::value);
+
+        std::vector<T> product(2 * n - 1);
+        std::vector<T> scratch(karatsuba_scratch_size(n));
+        karatsuba_multiply_balanced(a, padded.data(), n, product.data(), scratch.data());
+
+        std::copy(product.begin(), product.begin() + (n + m - 1), out);
+    }
+}
+
+/* Sparse operands */
+// A sparse operand is the list of its non-zero members (power, coefficient), from the highest power down.
+template<typename T>
+using sparse_terms = std::vector<std::pair<size_t, T> >;
+
+// Johnson's heap method: the products of the members are merged in descending order of their power
+// by a heap holding one pending product for every member of a, so the members of the product come out
+// one by one, each completely summed up. O(t1 * t2 * log t1) for t1 and t2 members, independent of the degree.
+// emit(power, coefficient) is called for every non-zero member of the product, from the highest power down.
+template<typename T, typename F>
+void sparse_heap_multiply(const sparse_terms<T>& a, const sparse_terms<T>& b, F emit)
+{
+    if (a.empty() || b.empty())
+        return;
+
+    // The heap is as large as the shorter operand.
+    if (a.size() > b.size())
+    {
+        sparse_heap_multiply(b, a, emit);
+        return;
+    }
+
+    Instrumentation::multiplications(a.size() * b.size());
+    Instrumentation::additions(a.size() * b.size());
+
+    // The heap holds the pair of members (i, j) whose product comes next in the row of a[i]:
+    // the rows are started one at a time, as a[i] * b[0] can't come before a[i - 1] * b[0].
+    struct Pending
+    {
+        size_t power;
+        size_t i, j;
+
+        bool operator < (const Pending& other) const { return this->power < other.power; }
+    };
+
+    std::vector<Pending> heap;
+    heap.reserve(a.size());
+    heap.push_back({ a[0].first + b[0].first, 0, 0 });
+
+    while (!heap.empty())
+    {
+        const size_t power = heap.front().power;
+        T coefficient = id_additive<T>::value;
+
+        // Sum up every product of this power, and replace each with the next one of its row.
+        while (!heap.empty() && heap.front().power == power)
+        {
+            std::pop_heap(heap.begin(), heap.end());
+            Pending& top = heap.back();
+            coefficient = coefficient + a[top.i].second * b[top.j].second;
+
+            if (top.j == 0 && top.i + 1 < a.size())
+            {
+                const size_t next_row = top.i + 1;
+                if (++top.j < b.size())
+                {
+                    top.power = a[top.i].first + b[top.j].first;
+                    std::push_heap(heap.begin(), heap.end());
+                }
+                else
+                    heap.pop_back();
+
+                heap.push_back({ a[next_row].first + b[0].first, next_row, 0 });
+                std::push_heap(heap.begin(), heap.end());
+            }
+            else if (++top.j < b.size())
+            {
+                top.power = a[top.i].first + b[top.j].first;
+                std::push_heap(heap.begin(), heap.end());
+            }
+            else
+                heap.pop_back();
+        }
+
+        // (The products can cancel each other out.)
+        if (coefficient != id_additive<T>::value)
+            emit(power, coefficient);
+    }
+}
+
+// The multiplication engine used by Polynomial<T> for contiguous storages.
+// Specialise this for coefficient types which have a faster method (see Residue.hpp).
+template<typename T>
+struct polynomial_multiplier
+{
+    static void multiply(const T* a, const size_t n, const T* b, const size_t m, T* out)
+    {
+        karatsuba_multiply(a, n, b, m, out);
+    }
+};
+
+#endif // _POLYNOMIAL_MULTIPLY_H
@@ -0,0 +1,452 @@
+#ifndef _POLYNOMIAL_SERIALIZATION_H
+#define _POLYNOMIAL_SERIALIZATION_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <new>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "Polynomial.hpp"
+#include "GF2Polynomial.hpp"
+#include "CoefficientSerialization.hpp"
+
+// A compact binary format of polynomials, to move them between programs (or save them) without formatting
+// them as text.
+//
+// Every number is little-endian. A serialized polynomial is a header of 32 bytes:
+//     offset 0   4 bytes   the magic "PLY\0"
+//            4   1 byte    the version of the format (polynomial_format_version)
+//            5   1 byte    the type of the coefficients (serialized_coefficient_type)
+//            6   1 byte    flags: 1 if the payload is sparse, 2 if it is native
+//            7   1 byte    the bytes of a coefficient in the payload (0 for the bits of GF(2))
+//            8   8 bytes   the modulus of the coefficients (0 if they are not residues)
+//           16   8 bytes   the degree (0 for the nullpolynomial)
+//           24   8 bytes   the number of coefficients in the payload (0 for the nullpolynomial)
+// followed by the payload:
+//  - dense:  every coefficient from x^0 up to x^degree
+//  - sparse: the non-zero members from the highest power down, each as the distance of its power from the
+//            previous one (from the degree for the first one), as a LEB128 varint, then the coefficient
+//  - GF(2):  the coefficients as bits, bit i of word w being the coefficient of x^(64w + i), in 8-byte words
+//            (the number of coefficients is degree + 1)
+//  - native: every coefficient from x^0 up, as its bytes in memory on the machine which wrote it, so that
+//            the payload can be used in place (see PolynomialView.hpp). The bytes are not checked when read.
+// Residues are packed into as few bytes as their modulus needs (a ResidueNum<7> takes a single byte).
+// (Their format is in Residue.hpp; the one of the other coefficients in CoefficientSerialization.hpp.)
+//
+// Polynomials with a contiguous storage are written dense, the others sparse (unless the native layout is asked
+// for); any layout can be read into any storage. The type and the modulus have to match the ones of the polynomial which is read,
+// otherwise (or if the data is not a valid polynomial, or it doesn't fit in memory) std::invalid_argument is thrown.
+
+const uint8_t polynomial_format_version = 1;
+
+// The coefficients reserved before any of them is read, at most: the header is not trusted with the memory,
+// so the buffers of larger polynomials grow as their coefficients are read (and a truncated one fails early).
+const uint64_t serialized_reserve_limit = 1 << 16;
+
+enum serialized_layout
+{
+    serialized_packed, // Dense or sparse, by the storage; the coefficients packed
+    serialized_native  // Dense, the coefficients as they are in memory
+};
+
+// The header of a serialized polynomial
+struct PolynomialHeader
+{
+    uint8_t version;
+    uint8_t type;
+    uint8_t flags;
+    uint8_t width;
+    uint64_t modulus;
+    uint64_t degree;
+    uint64_t count;
+
+    static const uint8_t sparse = 1;
+    static const uint8_t native = 2;
+
+    static const size_t size = 32;
+
+    void encode(unsigned char* bytes) const
+    {
+        encodeNumber(bytes, 0x00594C50, 4); // "PLY\0"
+        encodeNumber(bytes + 4, this->version, 1);
+        encodeNumber(bytes + 5, this->type, 1);
+        encodeNumber(bytes + 6, this->flags, 1);
+        encodeNumber(bytes + 7, this->width, 1);
+        encodeNumber(bytes + 8, this->modulus, 8);
+        encodeNumber(bytes + 16, this->degree, 8);
+        encodeNumber(bytes + 24, this->count, 8);
+    }
+
+    // Throws std::invalid_argument if the bytes are not a header of a supported version.
+    static PolynomialHeader decode(const unsigned char* bytes)
+    {
+        if (decodeNumber(bytes, 4) != 0x00594C50)
+            throw std::invalid_argument("The data is not a serialized polynomial.");
+
+        PolynomialHeader header;
+        header.version = static_cast<uint8_t>(decodeNumber(bytes + 4, 1));
+        header.type = static_cast<uint8_t>(decodeNumber(bytes + 5, 1));
+        header.flags = static_cast<uint8_t>(decodeNumber(bytes + 6, 1));
+        header.width = static_cast<uint8_t>(decodeNumber(bytes + 7, 1));
+        header.modulus = decodeNumber(bytes + 8, 8);
+        header.degree = decodeNumber(bytes + 16, 8);
+        header.count = decodeNumber(bytes + 24, 8);
+
+        if (header.version != polynomial_format_version)
+        {
+            std::stringstream errormessage;
+            errormessage << "The version " << int(header.version) << " of the serialized polynomial is not supported.";
+
+            throw std::invalid_argument(errormessage.str());
+        }
+
+        return header;
+    }
+
+    // Throws std::invalid_argument if the coefficients are not the ones of T (in the layout of the header).
+    template<typename T>
+    void checkCoefficients() const
+    {
+        typedef coefficient_serialization<T> format;
+
+        const bool native_layout = (this->flags & native) != 0;
+        const size_t width = native_layout ? sizeof(T) : format::width();
+        const uint8_t type = static_cast<uint8_t>(native_layout ? format::native_type : format::type);
+        if (this->type != type || type == 0 || this->modulus != format::modulus() || this->width != width)
+        {
+            std::stringstream errormessage;
+            errormessage << "The serialized polynomial has coefficients of type " << int(this->type)
+                << " modulo " << this->modulus << ", which are not the coefficients of the polynomial read.";
+
+            throw std::invalid_argument(errormessage.str());
+        }
+    }
+
+    private:
+        static void encodeNumber(unsigned char* bytes, uint64_t value, const size_t n)
+        {
+            for (size_t i = 0; i < n; ++i, value >>= 8)
+                bytes[i] = static_cast<unsigned char>(value & 0xFF);
+        }
+
+        static uint64_t decodeNumber(const unsigned char* bytes, const size_t n)
+        {
+            uint64_t value = 0;
+            for (size_t i = 0; i < n; ++i)
+                value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+
+            return value;
+        }
+};
+
+// Little-endian writing and reading. The writer collects the bytes into blocks, so that the stream is called
+// once per block instead of once per coefficient.
+class SerializationWriter
+{
+    public:
+        explicit SerializationWriter(std::ostream& o) : m_stream(o) { this->m_buffer.reserve(s_blockSize); }
+        ~SerializationWriter() { this->flush(); }
+
+        SerializationWriter(const SerializationWriter&) = delete;
+        SerializationWriter& operator = (const SerializationWriter&) = delete;
+
+        // The lowest n bytes of value
+        void number(uint64_t value, const size_t n)
+        {
+            for (size_t i = 0; i < n; ++i, value >>= 8)
+                this->m_buffer.push_back(static_cast<char>(value & 0xFF));
+
+            if (this->m_buffer.size() >= s_blockSize)
+                this->flush();
+        }
+
+        void varint(uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                this->m_buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+                value >>= 7;
+            }
+            this->number(value, 1);
+        }
+
+        void bytes(const void* data, const size_t n)
+        {
+            const char* begin = static_cast<const char*>(data);
+            this->m_buffer.insert(this->m_buffer.end(), begin, begin + n);
+
+            if (this->m_buffer.size() >= s_blockSize)
+                this->flush();
+        }
+
+        void header(const PolynomialHeader& header)
+        {
+            unsigned char encoded[PolynomialHeader::size];
+            header.encode(encoded);
+            this->bytes(encoded, sizeof(encoded));
+        }
+
+        void flush()
+        {
+            if (!this->m_buffer.empty())
+                this->m_stream.write(this->m_buffer.data(), static_cast<std::streamsize>(this->m_buffer.size()));
+            this->m_buffer.clear();
+        }
+
+    private:
+        static const size_t s_blockSize = 64 * 1024;
+
+        std::ostream& m_stream;
+        std::vector<char> m_buffer;
+};
+
+class SerializationReader
+{
+    public:
+        // (The bytes are taken from the buffer of the stream one by one, so nothing past the polynomial is read.)
+        explicit SerializationReader(std::istream& in) : m_stream(in), m_buffer(in.rdbuf()) {}
+
+        SerializationReader(const SerializationReader&) = delete;
+        SerializationReader& operator = (const SerializationReader&) = delete;
+
+        uint64_t number(const size_t n)
+        {
+            uint64_t value = 0;
+            for (size_t i = 0; i < n; ++i)
+                value |= static_cast<uint64_t>(this->byte()) << (8 * i);
+
+            return value;
+        }
+
+        uint64_t varint()
+        {
+            uint64_t value = 0;
+            for (unsigned shift = 0; ; shift += 7)
+            {
+                const uint8_t b = this->byte();
+                if (shift > 63 || (shift == 63 && (b & 0x7E) != 0))
+                    throw std::invalid_argument("The serialized polynomial has an invalid power.");
+
+                value |= static_cast<uint64_t>(b & 0x7F) << shift;
+                if ((b & 0x80) == 0)
+                    return value;
+            }
+        }
+
+        void bytes(void* data, const size_t n)
+        {
+            unsigned char* out = static_cast<unsigned char*>(data);
+            for (size_t i = 0; i < n; ++i)
+                out[i] = this->byte();
+        }
+
+        PolynomialHeader header()
+        {
+            unsigned char encoded[PolynomialHeader::size];
+            this->bytes(encoded, sizeof(encoded));
+            return PolynomialHeader::decode(encoded);
+        }
+
+    private:
+        std::istream& m_stream;
+        std::streambuf* m_buffer;
+
+        uint8_t byte()
+        {
+            const std::streambuf::int_type b = (this->m_buffer == nullptr ? std::streambuf::traits_type::eof() : this->m_buffer->sbumpc());
+            if (std::streambuf::traits_type::eq_int_type(b, std::streambuf::traits_type::eof()))
+            {
+                this->m_stream.setstate(std::ios_base::eofbit | std::ios_base::failbit);
+                throw std::invalid_argument("The serialized polynomial is truncated.");
+            }
+
+            return static_cast<uint8_t>(std::streambuf::traits_type::to_char_type(b));
+        }
+};
+
+// Write a polynomial in the binary format
+template<typename T, typename Storage>
+void write_polynomial(std::ostream& o, const Polynomial<T, Storage>& poly, const serialized_layout layout = serialized_packed)
+{
+    typedef coefficient_serialization<T> format;
+
+    PolynomialHeader header;
+    header.version = polynomial_format_version;
+    header.type = static_cast<uint8_t>(format::type);
+    header.flags = Storage::contiguous ? 0 : PolynomialHeader::sparse;
+    header.width = static_cast<uint8_t>(format::width());
+    header.modulus = format::modulus();
+    header.degree = poly.isNull() ? 0 : poly.degree();
+
+    SerializationWriter writer(o);
+    if (layout == serialized_native)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "The coefficients have to be trivially copyable");
+        if (format::native_type == 0)
+            throw std::invalid_argument("The coefficients of the polynomial have no native layout.");
+
+        header.type = static_cast<uint8_t>(format::native_type);
+        header.flags = PolynomialHeader::native;
+        header.width = static_cast<uint8_t>(sizeof(T));
+        header.count = poly.isNull() ? 0 : poly.degree() + 1;
+        writer.header(header);
+
+        for (size_t power = 0; power < header.count; ++power)
+        {
+            const T coefficient = poly.getMember(power);
+            writer.bytes(&coefficient, sizeof(T));
+        }
+    }
+    else if constexpr (Storage::contiguous)
+    {
+        header.count = poly.isNull() ? 0 : poly.degree() + 1;
+        writer.header(header);
+
+        for (size_t power = 0; power < header.count; ++power)
+            writer.number(format::pack(poly.getMember(power)), header.width);
+    }
+    else
+    {
+        const sparse_terms<T> members = poly.members();
+        header.count = members.size();
+        writer.header(header);
+
+        size_t previous = header.degree;
+        for (const std::pair<size_t, T>& member : members)
+        {
+            writer.varint(previous - member.first);
+            writer.number(format::pack(member.second), header.width);
+            previous = member.first;
+        }
+    }
+}
+
+// Read a polynomial of the binary format (see above)
+template<typename T, typename Storage>
+void read_polynomial(std::istream& in, Polynomial<T, Storage>& poly)
+{
+    typedef coefficient_serialization<T> format;
+
+    SerializationReader reader(in);
+    const PolynomialHeader header = reader.header();
+    header.checkCoefficients<T>();
+
+    const bool sparse = (header.flags & PolynomialHeader::sparse) != 0;
+    const bool native = (header.flags & PolynomialHeader::native) != 0;
+    if ((header.flags & ~(PolynomialHeader::sparse | PolynomialHeader::native)) || (sparse && native)
+        || (!sparse && header.count != (header.count == 0 ? 0 : header.degree + 1))
+        || (sparse && header.count > header.degree + 1))
+        throw std::invalid_argument("The header of the serialized polynomial is invalid.");
+    if (header.degree >= static_cast<uint64_t>(std::numeric_limits<std::ptrdiff_t>::max()) / sizeof(T))
+        throw std::invalid_argument("The degree of the serialized polynomial is too large.");
+
+    Polynomial<T, Storage> result;
+    try
+    {
+        typename Polynomial<T, Storage>::BatchEdit batch(result);
+        if (header.count > 0 && !sparse)
+            batch.reserve(static_cast<size_t>(std::min(header.degree, serialized_reserve_limit)));
+
+        if (native)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "The coefficients have to be trivially copyable");
+            for (size_t power = 0; power < header.count; ++power)
+            {
+                T coefficient;
+                reader.bytes(&coefficient, sizeof(T));
+                batch.setMember(power, coefficient);
+            }
+        }
+        else if (!sparse)
+        {
+            for (size_t power = 0; power < header.count; ++power)
+                batch.setMember(power, format::unpack(reader.number(header.width)));
+        }
+        else
+        {
+            // (The members are read before any is stored: the highest one makes a dense storage as large as the degree.)
+            sparse_terms<T> members;
+            members.reserve(static_cast<size_t>(std::min(header.count, serialized_reserve_limit)));
+
+            uint64_t power = header.degree;
+            for (uint64_t i = 0; i < header.count; ++i)
+            {
+                const uint64_t distance = reader.varint();
+                if (distance > power || (i > 0 && distance == 0))
+                    throw std::invalid_argument("The serialized polynomial has an invalid power.");
+
+                power -= distance;
+                members.emplace_back(static_cast<size_t>(power), format::unpack(reader.number(header.width)));
+            }
+
+            for (const std::pair<size_t, T>& member : members)
+                batch.setMember(member.first, member.second);
+        }
+    }
+    catch (const std::bad_alloc&)
+    {
+        throw std::invalid_argument("The serialized polynomial doesn't fit in memory.");
+    }
+
+    // (The degree of the header has to be the one of the coefficients.)
+    if (header.count > 0 && (result.isNull() || result.degree() != header.degree))
+        throw std::invalid_argument("The degree of the serialized polynomial doesn't match its coefficients.");
+
+    poly = std::move(result);
+}
+
+/* GF(2) polynomials, bit-packed */
+inline void write_polynomial(std::ostream& o, const GF2Polynomial& poly)
+{
+    PolynomialHeader header;
+    header.version = polynomial_format_version;
+    header.type = serialized_gf2;
+    header.flags = 0;
+    header.width = 0;
+    header.modulus = 2;
+    header.degree = poly.degree();
+    header.count = poly.isNull() ? 0 : poly.degree() + 1;
+
+    SerializationWriter writer(o);
+    writer.header(header);
+    for (const uint64_t word : poly.words())
+        writer.number(word, 8);
+}
+
+inline void read_polynomial(std::istream& in, GF2Polynomial& poly)
+{
+    SerializationReader reader(in);
+    const PolynomialHeader header = reader.header();
+    if (header.type != serialized_gf2 || header.modulus != 2 || header.width != 0 || header.flags != 0
+        || header.count != (header.count == 0 ? 0 : header.degree + 1))
+        throw std::invalid_argument("The data is not a serialized GF(2) polynomial.");
+
+    // (The words grow as they are read, see serialized_reserve_limit.)
+    const uint64_t count = (header.count == 0 ? 0 : header.degree / 64 + 1);
+    std::vector<uint64_t> words;
+    try
+    {
+        words.reserve(static_cast<size_t>(std::min(count, serialized_reserve_limit)));
+        for (uint64_t i = 0; i < count; ++i)
+            words.push_back(reader.number(8));
+    }
+    catch (const std::bad_alloc&)
+    {
+        throw std::invalid_argument("The serialized polynomial doesn't fit in memory.");
+    }
+
+    GF2Polynomial result = GF2Polynomial::fromWords(words);
+    if (header.count > 0 && (result.isNull() || result.degree() != header.degree))
+        throw std::invalid_argument("The degree of the serialized polynomial doesn't match its coefficients.");
+
+    poly = std::move(result);
+}
+
+#endif // _POLYNOMIAL_SERIALIZATION_H
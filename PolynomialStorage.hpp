@@ -0,0 +1,202 @@
+#ifndef _POLYNOMIAL_STORAGE_H
+#define _POLYNOMIAL_STORAGE_H
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "add_mult_identity.hpp"
+#include "Instrumentation.hpp"
+
+// Storage policies for the coefficients of Polynomial<T, Storage>.
+//
+// Every policy offers the same small interface:
+//  - get(p), set(p, c):  read and write the coefficient of x^p (set does not normalise)
+//  - erase(p):           set the coefficient of x^p to 0, keeping the storage normalised
+//  - degree():           the highest stored power (the degree of the polynomial once normalised)
+//  - normalize():        drop the 0 coefficients, so that the invariant of the polynomial holds
+//  - clear():            turn the storage into a nullpolynomial
+//  - forEachTerm(f):     call f(power, coefficient) for every non-zero member, from the highest power down
+//
+// The contiguous storages also expose their buffer through data() and size(),
+// where the i-th element is the coefficient of x^i. The arithmetic of Polynomial<> works on that buffer directly.
+//
+// Every policy takes the allocator of its memory (like an ArenaAllocator, see ArenaAllocator.hpp).
+// (By default the standard allocator, counting its allocations if the instrumentation is on; see Instrumentation.hpp.)
+
+// Dense, degree-indexed storage. Suitable for polynomials with few zero coefficients.
+template<typename T, typename Allocator = polynomial_allocator<T> >
+class DenseStorage
+{
+    public:
+        static const bool contiguous = true;
+
+        // A buffer of coefficients in the memory of the storage
+        typedef std::vector<T, Allocator> buffer;
+
+        size_t degree() const
+        {
+            return this->m_coefficients.empty() ? 0 : this->m_coefficients.size() - 1;
+        }
+
+        T get(const size_t power) const
+        {
+            if (power < this->m_coefficients.size())
+                return this->m_coefficients[power];
+            else
+                return id_additive<T>::value;
+        }
+
+        void set(const size_t power, const T& coefficient)
+        {
+            if (power >= this->m_coefficients.size())
+            {
+                // Don't grow the buffer just to store a zero.
+                if (coefficient == id_additive<T>::value)
+                    return;
+
+                this->m_coefficients.resize(power + 1, id_additive<T>::value);
+            }
+
+            this->m_coefficients[power] = coefficient;
+        }
+
+        void erase(const size_t power)
+        {
+            if (power >= this->m_coefficients.size())
+                return;
+
+            this->m_coefficients[power] = id_additive<T>::value;
+
+            // Only removing the LC can break the invariant.
+            if (power + 1 == this->m_coefficients.size())
+                this->normalize();
+        }
+
+        void normalize()
+        {
+            // The invariant is that the highest stored coefficient is not 0.
+            // (Zero coefficients below the degree are part of the dense representation.)
+            while (!this->m_coefficients.empty() && this->m_coefficients.back() == id_additive<T>::value)
+                this->m_coefficients.pop_back();
+        }
+
+        void clear()
+        {
+            this->m_coefficients.clear();
+        }
+
+        template<typename F>
+        void forEachTerm(F f) const
+        {
+            for (size_t i = this->m_coefficients.size(); i-- > 0; )
+                if (this->m_coefficients[i] != id_additive<T>::value)
+                    f(i, this->m_coefficients[i]);
+        }
+
+        // Contiguous access
+        size_t size() const { return this->m_coefficients.size(); }
+        T* data() { return this->m_coefficients.data(); }
+        const T* data() const { return this->m_coefficients.data(); }
+
+        // Make room for n coefficients without changing the polynomial.
+        void reserve(const size_t n)
+        {
+            this->m_coefficients.reserve(n);
+        }
+
+        // Resize the buffer to hold n coefficients. New coefficients are 0.
+        void resize(const size_t n)
+        {
+            this->m_coefficients.resize(n, id_additive<T>::value);
+        }
+
+        // Exchange the buffer with an already computed coefficient vector.
+        void swap(buffer& coefficients)
+        {
+            this->m_coefficients.swap(coefficients);
+        }
+
+    private:
+        buffer m_coefficients;
+};
+
+// Sparse storage, keeping only the non-zero members in a map ordered by descending power.
+// Suitable for polynomials of high degree with few members.
+template<typename T, typename Allocator = polynomial_allocator<T> >
+class SparseStorage
+{
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<std::pair<const size_t, T> > nodeAllocator;
+    typedef std::map<size_t, T, std::greater<size_t>, nodeAllocator> coefficientsMap;
+
+    public:
+        static const bool contiguous = false;
+
+        size_t degree() const
+        {
+            // The map is ordered descending, so the first key is the highest power.
+            return this->m_coefficients.empty() ? 0 : this->m_coefficients.cbegin()->first;
+        }
+
+        T get(const size_t power) const
+        {
+            typename coefficientsMap::const_iterator cit = this->m_coefficients.find(power);
+            if (cit != this->m_coefficients.cend())
+                return cit->second;
+            else
+                return id_additive<T>::value; // Non-existant members are just not stored: they are mathematically there with 0 coefficient.
+        }
+
+        void set(const size_t power, const T& coefficient)
+        {
+            this->m_coefficients[power] = coefficient; // Add or reassign a member
+        }
+
+        void erase(const size_t power)
+        {
+            this->m_coefficients.erase(power);
+        }
+
+        void normalize()
+        {
+            // Remove the 0 coefficient parts from the map
+            for (typename coefficientsMap::iterator it = this->m_coefficients.begin(); it != this->m_coefficients.end(); )
+            {
+                if (it->second == id_additive<T>::value)
+                    it = this->m_coefficients.erase(it);
+                else
+                    ++it;
+            }
+        }
+
+        void clear()
+        {
+            this->m_coefficients.clear();
+        }
+
+        template<typename F>
+        void forEachTerm(F f) const
+        {
+            for (typename coefficientsMap::const_iterator cit = this->m_coefficients.cbegin();
+                cit != this->m_coefficients.cend(); ++cit)
+                if (cit->second != id_additive<T>::value)
+                    f(cit->first, cit->second);
+        }
+
+        // Number of stored members
+        size_t terms() const { return this->m_coefficients.size(); }
+
+        // Store a member below every stored one. Members appended from the highest power down
+        // take amortised constant time (instead of a lookup each).
+        void append(const size_t power, const T& coefficient)
+        {
+            this->m_coefficients.emplace_hint(this->m_coefficients.end(), power, coefficient);
+        }
+
+    private:
+        coefficientsMap m_coefficients;
+};
+
+#endif // _POLYNOMIAL_STORAGE_H
@@ -0,0 +1,496 @@
+#ifndef _POLYNOMIAL_TEXT_H
+#define _POLYNOMIAL_TEXT_H
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include "Polynomial.hpp"
+#include "GF2Polynomial.hpp"
+#include "CoefficientText.hpp"
+
+// Polynomials as text, without the streams: formatted into a buffer of the caller by std::to_chars,
+// and parsed by std::from_chars, so that large polynomials (and many of them) go through at the speed of memory.
+//
+// There are two forms of the text:
+//  - printed:      as operator<< prints the polynomials, "- 5x^2 + 3x - 2": the members from the highest power
+//                  down, the sign apart from the coefficient, and the coefficients 1 of the powers of x omitted.
+//                  When parsed, the members may come in any order and without blanks ("3x-2-5x^2"),
+//                  the members of the same power are added, and a sign may be attached to the coefficient ("-2").
+//  - coefficients: every coefficient from the highest power down, separated by spaces, "-5 3 -2"
+//                  (as in the batch mode of main).
+// The nullpolynomial is "0" in both.
+//
+// format_polynomial and parse_polynomial work like std::to_chars and std::from_chars: the result points past
+// the text, or tells the error:
+//  - errc::value_too_large:     the buffer is too short (its contents are then unspecified)
+//  - errc::invalid_argument:    the text is not a polynomial
+//  - errc::result_out_of_range: a coefficient doesn't fit its type, or a power the polynomial (or the memory) cannot hold
+// When parsing fails, ptr points at the text in error, and the polynomial is not modified.
+// (The blanks, spaces and tabs, before and after the polynomial are skipped; the text after it is left to the caller.)
+//
+// The text of the coefficients is given by coefficient_text<T>: the built-in arithmetic types in CoefficientText.hpp,
+// the residues in Residue.hpp.
+
+enum polynomial_text_form
+{
+    text_printed,     // "- 5x^2 + 3x - 2"
+    text_coefficients // "-5 3 -2"
+};
+
+// Writes the text into a buffer, or into a stream through a buffer of blocks.
+// Once the buffer is full, nothing more is written, and the result is errc::value_too_large.
+class TextFormatter
+{
+    public:
+        // Into [first, last)
+        TextFormatter(char* first, char* last) : m_stream(nullptr), m_first(first), m_position(first), m_last(last), m_full(false) {}
+
+        // Into the stream (see print_polynomial)
+        explicit TextFormatter(std::ostream& o)
+            : m_stream(&o), m_block(s_blockSize), m_first(m_block.data()), m_position(m_first), m_last(m_first + s_blockSize), m_full(false) {}
+
+        TextFormatter(const TextFormatter&) = delete;
+        TextFormatter& operator = (const TextFormatter&) = delete;
+
+        std::to_chars_result result() const
+        {
+            if (this->m_full)
+                return { this->m_last, std::errc::value_too_large };
+            return { this->m_position, std::errc() };
+        }
+
+        // Called before every member: a stream gets the block once the room left might not hold one.
+        // (The block is written at the end by flush.)
+        void boundary()
+        {
+            if (this->m_stream != nullptr && this->m_last - this->m_position < static_cast<std::ptrdiff_t>(s_memberSize))
+                this->flush();
+        }
+
+        void flush()
+        {
+            if (this->m_full)
+                throw std::length_error("A member of the polynomial is too long to be formatted.");
+
+            this->m_stream->write(this->m_first, static_cast<std::streamsize>(this->m_position - this->m_first));
+            this->m_position = this->m_first;
+        }
+
+        void character(const char c)
+        {
+            if (this->m_position == this->m_last)
+                this->m_full = true;
+            else if (!this->m_full)
+                *this->m_position++ = c;
+        }
+
+        void text(const char* s, const size_t n)
+        {
+            if (static_cast<size_t>(this->m_last - this->m_position) < n)
+                this->m_full = true;
+            else if (!this->m_full)
+            {
+                std::memcpy(this->m_position, s, n);
+                this->m_position += n;
+            }
+        }
+
+        template<typename T>
+        void coefficient(const T& value)
+        {
+            this->written(coefficient_text<T>::format(this->m_position, this->m_last, value));
+        }
+
+        // x^power, x, or nothing for the constant member
+        void power(const size_t power)
+        {
+            if (power > 1)
+            {
+                this->text("x^", 2);
+                this->written(std::to_chars(this->m_position, this->m_last, power));
+            }
+            else if (power == 1)
+                this->character('x');
+        }
+
+        // A member of the printed form, by the rules of operator<<
+        template<typename T>
+        void member(const size_t power, const T& value, const bool first)
+        {
+            if (!first)
+                this->character(' ');
+
+            if (value < id_additive<T>::value)
+                this->text("- ", 2);
+            else if (value > id_additive<T>::value && !first)
+                this->text("+ ", 2);
+
+            // The 1 multiplier of the powers of x is omitted; the sign was printed already.
+            if (power != 0)
+            {
+                if constexpr (id_multiplicative_exists<T>::value)
+                {
+                    if constexpr (abs_value<T>::known)
+                    {
+                        if (abs_value<T>::abs(value) != id_multiplicative<T>::value)
+                            this->coefficient(abs_value<T>::abs(value));
+                    }
+                    else if (value != id_multiplicative<T>::value)
+                        this->coefficient(value);
+                }
+                else
+                    this->coefficient(value);
+            }
+            else
+            {
+                if constexpr (abs_value<T>::known)
+                    this->coefficient(value < abs_value<T>::abs(value) ? abs_value<T>::abs(value) : value);
+                else
+                    this->coefficient(value);
+            }
+
+            this->power(power);
+        }
+
+    private:
+        // The longest member of the built-in coefficient types is below this
+        static const size_t s_memberSize = 256;
+        static const size_t s_blockSize = 64 * 1024;
+
+        std::ostream* m_stream;
+        std::vector<char> m_block;
+        char* m_first;
+        char* m_position;
+        char* m_last;
+        bool m_full;
+
+        void written(const std::to_chars_result result)
+        {
+            if (result.ec != std::errc())
+                this->m_full = true;
+            else if (!this->m_full)
+                this->m_position = result.ptr;
+        }
+};
+
+// Reads the text of a polynomial: the members of the printed form, or the coefficients from the highest power down.
+// The members are handed over to add(power, coefficient, negative) (the sign of a coefficient of the printed form
+// is apart from it), which returns false if the polynomial cannot hold the power. Such a power (or one which
+// the memory cannot hold) is errc::result_out_of_range, like one which doesn't fit size_t.
+class TextParser
+{
+    public:
+        static const char* skipBlanks(const char* first, const char* last)
+        {
+            while (first != last && (*first == ' ' || *first == '\t'))
+                ++first;
+            return first;
+        }
+
+        template<typename T, typename F>
+        static std::from_chars_result printed(const char* first, const char* last, F add)
+        {
+            const char* position = skipBlanks(first, last);
+            for (bool firstMember = true; ; firstMember = false)
+            {
+                bool negative = false;
+                if (position != last && (*position == '+' || *position == '-'))
+                {
+                    negative = (*position == '-');
+                    position = skipBlanks(position + 1, last);
+                }
+                else if (!firstMember)
+                    return { position, std::errc() };
+
+                // The coefficient (1 if omitted)
+                T coefficient = id_multiplicative<T>::value;
+                if (position == last || *position == '+' || *position == '-')
+                    return { position, std::errc::invalid_argument };
+                if (*position != 'x')
+                {
+                    const std::from_chars_result read = coefficient_text<T>::parse(position, last, coefficient);
+                    if (read.ec != std::errc())
+                        return { position, read.ec };
+                    position = read.ptr;
+                }
+
+                // The power
+                size_t power = 0;
+                const char* powerText = position;
+                if (position != last && *position == 'x')
+                {
+                    power = 1;
+                    if (++position != last && *position == '^')
+                    {
+                        powerText = position + 1;
+                        const std::from_chars_result read = std::from_chars(position + 1, last, power);
+                        if (read.ec != std::errc())
+                            return { position + 1, read.ec };
+                        position = read.ptr;
+                    }
+                }
+
+                bool added = false;
+                try
+                {
+                    added = add(power, coefficient, negative);
+                }
+                catch (const std::bad_alloc&)
+                {
+                }
+                catch (const std::length_error&)
+                {
+                }
+                if (!added)
+                    return { powerText, std::errc::result_out_of_range };
+
+                position = skipBlanks(position, last);
+            }
+        }
+
+        // (The coefficients are collected in order, from the highest power down.)
+        template<typename T>
+        static std::from_chars_result coefficients(const char* first, const char* last, std::vector<T>& coefficients)
+        {
+            const char* position = skipBlanks(first, last);
+            while (true)
+            {
+                T coefficient = id_additive<T>::value;
+                const std::from_chars_result read = coefficient_text<T>::parse(position, last, coefficient);
+                if (read.ec != std::errc())
+                {
+                    if (coefficients.empty() || read.ec != std::errc::invalid_argument)
+                        return { position, read.ec };
+                    return { position, std::errc() };
+                }
+
+                coefficients.push_back(coefficient);
+
+                // (The coefficients are separated by blanks.)
+                position = skipBlanks(read.ptr, last);
+                if (position == read.ptr)
+                    return { position, std::errc() };
+            }
+        }
+};
+
+// Format a polynomial through the formatter (see format_polynomial and print_polynomial below)
+template<typename T, typename Storage>
+void format_polynomial(TextFormatter& out, const Polynomial<T, Storage>& poly, const polynomial_text_form form)
+{
+    static_assert(coefficient_text<T>::known, "The coefficients have no text (see coefficient_text)");
+
+    if (poly.isNull())
+    {
+        out.character('0');
+        return;
+    }
+    else if (form == text_printed && poly.isConstant())
+    {
+        out.coefficient(poly.getMember(0));
+        return;
+    }
+
+    bool first = true;
+    size_t next = poly.degree();
+    auto coefficient = [&out, &first](const T& value)
+    {
+        out.boundary();
+        if (!first)
+            out.character(' ');
+        out.coefficient(value);
+        first = false;
+    };
+
+    // Every member from the highest power down (the zero ones only in the list of the coefficients)
+    auto member = [&](const size_t power, const T& value)
+    {
+        if (form == text_printed)
+        {
+            out.boundary();
+            out.member(power, value, first);
+            first = false;
+            return;
+        }
+
+        for (; next > power; --next)
+            coefficient(id_additive<T>::value);
+        coefficient(value);
+        --next;
+    };
+
+    if constexpr (Storage::contiguous)
+    {
+        for (size_t power = poly.degree() + 1; power-- > 0; )
+        {
+            const T value = poly.getMember(power);
+            if (form == text_coefficients || value != id_additive<T>::value)
+                member(power, value);
+        }
+    }
+    else
+    {
+        for (const std::pair<size_t, T>& term : poly.members())
+            member(term.first, term.second);
+
+        // (The powers below the lowest member)
+        if (form == text_coefficients && poly.getMember(0) == id_additive<T>::value)
+        {
+            for (size_t power = next + 1; power-- > 0; )
+                coefficient(id_additive<T>::value);
+        }
+    }
+}
+
+// Format a polynomial into [first, last), like std::to_chars (see above)
+template<typename T, typename Storage>
+std::to_chars_result format_polynomial(char* first, char* last, const Polynomial<T, Storage>& poly, const polynomial_text_form form = text_printed)
+{
+    TextFormatter out(first, last);
+    format_polynomial(out, poly, form);
+    return out.result();
+}
+
+// Write a polynomial to a stream, formatted in blocks (in the printed form, the same text as operator<<)
+template<typename T, typename Storage>
+void print_polynomial(std::ostream& o, const Polynomial<T, Storage>& poly, const polynomial_text_form form = text_printed)
+{
+    TextFormatter out(o);
+    format_polynomial(out, poly, form);
+    out.flush();
+}
+
+// Parse a polynomial of [first, last), like std::from_chars (see above)
+template<typename T, typename Storage>
+std::from_chars_result parse_polynomial(const char* first, const char* last, Polynomial<T, Storage>& poly, const polynomial_text_form form = text_printed)
+{
+    static_assert(coefficient_text<T>::known, "The coefficients have no text (see coefficient_text)");
+
+    Polynomial<T, Storage> result;
+    std::from_chars_result read;
+    if (form == text_printed)
+    {
+        typename Polynomial<T, Storage>::BatchEdit edit(result);
+        read = TextParser::printed<T>(first, last, [&edit](const size_t power, const T& coefficient, const bool negative)
+        {
+            // (Nothing is reserved from the powers: the storage grows with the members actually read.)
+            if (power >= static_cast<size_t>(std::numeric_limits<std::ptrdiff_t>::max()) / sizeof(T))
+                return false;
+
+            edit.addToMember(power, negative ? id_additive<T>::value - coefficient : coefficient);
+            return true;
+        });
+    }
+    else
+    {
+        std::vector<T> coefficients;
+        read = TextParser::coefficients(first, last, coefficients);
+
+        typename Polynomial<T, Storage>::BatchEdit edit(result);
+        if (!coefficients.empty())
+            edit.reserve(coefficients.size() - 1);
+        for (size_t i = 0; i < coefficients.size(); ++i)
+            edit.setMember(coefficients.size() - 1 - i, coefficients[i]);
+    }
+
+    if (read.ec == std::errc())
+        poly = std::move(result);
+    return read;
+}
+
+// The same for the polynomials over GF(2). The coefficients of the text are taken modulo 2.
+inline void format_polynomial(TextFormatter& out, const GF2Polynomial& poly, const polynomial_text_form form)
+{
+    if (poly.isNull())
+    {
+        out.character('0');
+        return;
+    }
+
+    if (form == text_coefficients)
+    {
+        for (size_t power = poly.degree() + 1; power-- > 0; )
+        {
+            out.boundary();
+            out.character(poly.getMember(power) ? '1' : '0');
+            if (power > 0)
+                out.character(' ');
+        }
+        return;
+    }
+
+    // Every member is 1 * x^power, so only the powers are printed (as operator<< does).
+    const std::vector<uint64_t>& words = poly.words();
+    bool first = true;
+    for (size_t w = words.size(); w-- > 0; )
+    {
+        for (uint64_t word = words[w]; word != 0; )
+        {
+            const unsigned bit = 63 - static_cast<unsigned>(__builtin_clzll(word));
+            word &= ~(uint64_t(1) << bit);
+
+            const size_t power = 64 * w + bit;
+            out.boundary();
+            if (!first)
+                out.text(" + ", 3);
+            if (power == 0)
+                out.character('1');
+            else
+                out.power(power);
+            first = false;
+        }
+    }
+}
+
+inline std::to_chars_result format_polynomial(char* first, char* last, const GF2Polynomial& poly, const polynomial_text_form form = text_printed)
+{
+    TextFormatter out(first, last);
+    format_polynomial(out, poly, form);
+    return out.result();
+}
+
+inline void print_polynomial(std::ostream& o, const GF2Polynomial& poly, const polynomial_text_form form = text_printed)
+{
+    TextFormatter out(o);
+    format_polynomial(out, poly, form);
+    out.flush();
+}
+
+inline std::from_chars_result parse_polynomial(const char* first, const char* last, GF2Polynomial& poly, const polynomial_text_form form = text_printed)
+{
+    std::vector<uint64_t> words;
+    auto add = [&words](const size_t power, const long coefficient)
+    {
+        if ((coefficient & 1) == 0)
+            return true;
+        if (power / 64 >= words.size())
+            words.resize(power / 64 + 1, 0);
+        words[power / 64] ^= uint64_t(1) << (power % 64);
+        return true;
+    };
+
+    std::from_chars_result read;
+    if (form == text_printed)
+        read = TextParser::printed<long>(first, last, [&add](const size_t power, const long coefficient, bool) { return add(power, coefficient); });
+    else
+    {
+        std::vector<long> coefficients;
+        read = TextParser::coefficients(first, last, coefficients);
+        for (size_t i = 0; i < coefficients.size(); ++i)
+            add(coefficients.size() - 1 - i, coefficients[i]);
+    }
+
+    if (read.ec == std::errc())
+        poly = GF2Polynomial::fromWords(words);
+    return read;
+}
+
+#endif // _POLYNOMIAL_TEXT_H
@@ -0,0 +1,40 @@
+#ifndef _POLYNOMIAL_THRESHOLDS_H
+#define _POLYNOMIAL_THRESHOLDS_H
+
+#include <cstddef>
+
+// Tunable thresholds of the polynomial algorithms.
+// Below them the classical methods are used, as the asymptotically faster ones don't pay off for small inputs.
+struct polynomial_thresholds
+{
+    // Operands with at most this many coefficients (the shorter one) are multiplied by the schoolbook method,
+    // this is also the base case of the Karatsuba recursion.
+    static inline size_t karatsuba = 32;
+
+    // Operands with at least this many coefficients (the shorter one) are multiplied by number-theoretic transform,
+    // if the coefficient type supports it (see NTT.hpp and Residue.hpp).
+    static inline size_t ntt = 64;
+
+    // Divisions where both the quotient and the divisor have at least this many coefficients
+    // compute the quotient from the Newton-iterated reciprocal of the divisor (see PolynomialDivision.hpp).
+    static inline size_t newton_division = 128;
+
+    // Extended Euclidean algorithms where both polynomials have at least this degree use the half-GCD
+    // (see HalfGCD.hpp). This is also the size where its recursion falls back to plain division steps.
+    static inline size_t half_gcd = 256;
+
+    // Divisors with at most this many non-zero members below the LC (and at least 4 times as many coefficients)
+    // are subtracted member by member in the long division, which then costs O(quotient * members);
+    // the Newton division is not used for them.
+    static inline size_t sparse_division = 16;
+
+    // Multipoint evaluations at no more than this many points use Horner's rule at every point;
+    // this is also the number of points in the leaves of the subproduct tree (see SubproductTree.hpp).
+    static inline size_t multipoint_evaluation = 32;
+
+    // GF(2) polynomials with at least this many words (64 coefficients each, the shorter one)
+    // are multiplied by Karatsuba's method over the carry-less word products (see GF2Polynomial.hpp).
+    static inline size_t gf2_karatsuba = 16;
+};
+
+#endif // _POLYNOMIAL_THRESHOLDS_H
@@ -0,0 +1,424 @@
+#ifndef _POLYNOMIAL_VIEW_H
+#define _POLYNOMIAL_VIEW_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "add_mult_identity.hpp"
+#include "PolynomialMultiply.hpp"
+#include "PolynomialDivision.hpp"
+#include "PolynomialSerialization.hpp"
+#include "Polynomial.hpp"
+
+// Polynomials used in place, from memory-mapped files.
+//
+// A file in the native layout of PolynomialSerialization.hpp holds the coefficients as they are in memory, so a
+// PolynomialView reads them straight from the mapping: nothing is loaded or copied, and the pages are read by
+// the operating system as they are touched (and dropped again under memory pressure). A view can be multiplied
+// and divided like a contiguous polynomial, and the results are written to new mapped files (the same way),
+// so the inputs and the outputs of a computation never have to fit into the memory at once:
+//     write_polynomial(file, poly, serialized_native);    // once
+//     ...
+//     const PolynomialView<T> a("a.ply"), b("b.ply");
+//     const PolynomialView<T> product = multiply(a, b, "product.ply");
+//     T value = product.at(t);
+// (The temporaries of the fast multiplication and division still take memory like the ones of Polynomial<T>.)
+//
+// Only for POSIX systems. The errors of the system are thrown as std::system_error, and files which are not
+// polynomials of the type in the native layout as std::invalid_argument.
+
+// A memory mapping of a whole file
+class MappedFile
+{
+    public:
+        MappedFile() : m_descriptor(-1), m_data(nullptr), m_size(0) {}
+
+        // Map an existing file for reading
+        explicit MappedFile(const std::string& path);
+
+        // Create (or replace) a file of the given size, mapped for writing
+        static MappedFile create(const std::string& path, const size_t size);
+
+        ~MappedFile() { this->close(); }
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator = (MappedFile&& other) noexcept;
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator = (const MappedFile&) = delete;
+
+        const unsigned char* data() const { return static_cast<const unsigned char*>(this->m_data); }
+        unsigned char* data() { return static_cast<unsigned char*>(this->m_data); }
+        size_t size() const { return this->m_size; }
+
+        // Cut a file mapped for writing to its first size bytes (and map what is left)
+        void truncate(const size_t size);
+
+        void close();
+
+    private:
+        int m_descriptor; // Kept open for the mappings which are written (-1 otherwise)
+        void* m_data;
+        size_t m_size;
+
+        static std::system_error error(const std::string& what, const std::string& path)
+        {
+            return std::system_error(errno, std::generic_category(), what + " " + path);
+        }
+
+        void map(const int protection, const std::string& path);
+};
+
+inline MappedFile::MappedFile(const std::string& path) : m_descriptor(-1), m_data(nullptr), m_size(0)
+{
+    const int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        throw error("Cannot open", path);
+
+    struct stat status;
+    if (::fstat(descriptor, &status) != 0)
+    {
+        const std::system_error failure = error("Cannot read the size of", path);
+        ::close(descriptor);
+        throw failure;
+    }
+
+    // (A read-only mapping stays valid without its descriptor.)
+    this->m_descriptor = descriptor;
+    this->m_size = static_cast<size_t>(status.st_size);
+    try
+    {
+        this->map(PROT_READ, path);
+    }
+    catch (...)
+    {
+        this->close();
+        throw;
+    }
+
+    ::close(this->m_descriptor);
+    this->m_descriptor = -1;
+}
+
+inline MappedFile MappedFile::create(const std::string& path, const size_t size)
+{
+    MappedFile file;
+    file.m_descriptor = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (file.m_descriptor < 0)
+        throw error("Cannot create", path);
+
+    if (::ftruncate(file.m_descriptor, static_cast<off_t>(size)) != 0)
+        throw error("Cannot resize", path);
+
+    file.m_size = size;
+    file.map(PROT_READ | PROT_WRITE, path);
+    return file;
+}
+
+inline MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_descriptor(other.m_descriptor), m_data(other.m_data), m_size(other.m_size)
+{
+    other.m_descriptor = -1;
+    other.m_data = nullptr;
+    other.m_size = 0;
+}
+
+inline MappedFile& MappedFile::operator = (MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        this->close();
+        std::swap(this->m_descriptor, other.m_descriptor);
+        std::swap(this->m_data, other.m_data);
+        std::swap(this->m_size, other.m_size);
+    }
+
+    return *this;
+}
+
+inline void MappedFile::map(const int protection, const std::string& path)
+{
+    // (An empty file has nothing to map.)
+    if (this->m_size == 0)
+        return;
+
+    void* data = ::mmap(nullptr, this->m_size, protection, MAP_SHARED, this->m_descriptor, 0);
+    if (data == MAP_FAILED)
+        throw error("Cannot map", path);
+
+    this->m_data = data;
+}
+
+inline void MappedFile::truncate(const size_t size)
+{
+    if (this->m_descriptor < 0)
+        throw std::logic_error("Only the files mapped for writing can be truncated.");
+
+    if (this->m_data != nullptr)
+        ::munmap(this->m_data, this->m_size);
+    this->m_data = nullptr;
+
+    if (::ftruncate(this->m_descriptor, static_cast<off_t>(size)) != 0)
+        throw std::system_error(errno, std::generic_category(), "Cannot resize a mapped file");
+
+    this->m_size = size;
+    this->map(PROT_READ | PROT_WRITE, "a mapped file");
+}
+
+inline void MappedFile::close()
+{
+    if (this->m_data != nullptr)
+        ::munmap(this->m_data, this->m_size);
+    if (this->m_descriptor >= 0)
+        ::close(this->m_descriptor);
+
+    this->m_descriptor = -1;
+    this->m_data = nullptr;
+    this->m_size = 0;
+}
+
+// A read-only polynomial over the coefficients of a mapped file in the native layout
+template<typename T>
+class PolynomialView
+{
+    static_assert(std::is_trivially_copyable<T>::value, "The coefficients of a view have to be trivially copyable");
+
+    public:
+        // The nullpolynomial (without a file)
+        PolynomialView() : m_coefficients(nullptr), m_size(0) {}
+
+        // Map the file at the given path
+        explicit PolynomialView(const std::string& path) : PolynomialView(MappedFile(path)) {}
+
+        // Take over a mapping
+        explicit PolynomialView(MappedFile file);
+
+        // (The moved view is left the nullpolynomial.)
+        PolynomialView(PolynomialView&& other) noexcept
+            : m_file(std::move(other.m_file)), m_coefficients(other.m_coefficients), m_size(other.m_size)
+        {
+            other.m_coefficients = nullptr;
+            other.m_size = 0;
+        }
+
+        PolynomialView& operator = (PolynomialView&& other) noexcept
+        {
+            this->m_file = std::move(other.m_file);
+            this->m_coefficients = std::exchange(other.m_coefficients, nullptr);
+            this->m_size = std::exchange(other.m_size, 0);
+            return *this;
+        }
+
+        // Get the degree (0 for the nullpolynomial)
+        size_t degree() const { return this->m_size == 0 ? 0 : this->m_size - 1; }
+        bool isNull() const { return this->m_size == 0; }
+
+        // Get the nth coefficient
+        T getMember(const size_t index) const
+        {
+            return index < this->m_size ? this->m_coefficients[index] : id_additive<T>::value;
+        }
+
+        T leadingCoefficient() const { return this->getMember(this->degree()); }
+
+        // Evaluate at t, by Horner's rule (see Polynomial<T>::at)
+        T at(const T t) const;
+
+        // The coefficients in the mapping, the ith element being the coefficient of x^i
+        const T* data() const { return this->m_coefficients; }
+        size_t size() const { return this->m_size; }
+
+        // A copy of the polynomial in memory
+        template<typename Storage = DenseStorage<T> >
+        Polynomial<T, Storage> toPolynomial() const;
+
+    private:
+        MappedFile m_file;
+        const T* m_coefficients;
+        size_t m_size;
+};
+
+template<typename T>
+PolynomialView<T>::PolynomialView(MappedFile file) : m_file(std::move(file)), m_coefficients(nullptr), m_size(0)
+{
+    if (this->m_file.size() < PolynomialHeader::size)
+        throw std::invalid_argument("The mapped file is not a serialized polynomial.");
+
+    const PolynomialHeader header = PolynomialHeader::decode(this->m_file.data());
+    if (!(header.flags & PolynomialHeader::native) || (header.flags & PolynomialHeader::sparse))
+        throw std::invalid_argument("The mapped polynomial is not in the native layout.");
+    header.checkCoefficients<T>();
+
+    if (header.count != (header.count == 0 ? 0 : header.degree + 1)
+        || header.count > (this->m_file.size() - PolynomialHeader::size) / sizeof(T))
+        throw std::invalid_argument("The mapped polynomial is truncated.");
+
+    // (The mapping is aligned to a page, and the payload follows the 32 bytes of the header.)
+    static_assert(alignof(T) <= 32, "The coefficients have to be aligned in the mapping");
+    this->m_coefficients = reinterpret_cast<const T*>(this->m_file.data() + PolynomialHeader::size);
+    this->m_size = static_cast<size_t>(header.count);
+
+    if (this->m_size > 0 && this->m_coefficients[this->m_size - 1] == id_additive<T>::value)
+        throw std::invalid_argument("The leading coefficient of the mapped polynomial is 0.");
+}
+
+template<typename T>
+T PolynomialView<T>::at(const T t) const
+{
+    if (this->m_size == 0)
+        return id_additive<T>::value;
+
+    T result = this->m_coefficients[this->m_size - 1];
+    for (size_t power = this->m_size - 1; power-- > 0; )
+        result = result * t + this->m_coefficients[power];
+
+    Instrumentation::multiplications(this->m_size - 1);
+    Instrumentation::additions(this->m_size - 1);
+    return result;
+}
+
+template<typename T>
+template<typename Storage>
+Polynomial<T, Storage> PolynomialView<T>::toPolynomial() const
+{
+    Polynomial<T, Storage> result;
+    typename Polynomial<T, Storage>::BatchEdit batch(result);
+    if (this->m_size > 0)
+        batch.reserve(this->m_size - 1);
+
+    for (size_t power = 0; power < this->m_size; ++power)
+        batch.setMember(power, this->m_coefficients[power]);
+
+    return result;
+}
+
+// A polynomial written into a new mapped file (in the native layout): the coefficients are computed
+// in the mapping, and finish() turns the file into a view.
+template<typename T>
+class PolynomialOutputFile
+{
+    static_assert(std::is_trivially_copyable<T>::value, "The coefficients of a view have to be trivially copyable");
+
+    public:
+        // A file with room for n coefficients, all of them 0
+        PolynomialOutputFile(const std::string& path, const size_t n)
+            : m_file(MappedFile::create(path, PolynomialHeader::size + n * sizeof(T))), m_size(n)
+        {
+            std::fill(this->data(), this->data() + n, id_additive<T>::value);
+        }
+
+        T* data() { return reinterpret_cast<T*>(this->m_file.data() + PolynomialHeader::size); }
+        size_t size() const { return this->m_size; }
+
+        // Write the header (of the polynomial without its 0 members on the top), and cut the file after them.
+        PolynomialView<T> finish();
+
+    private:
+        MappedFile m_file;
+        size_t m_size;
+};
+
+template<typename T>
+PolynomialView<T> PolynomialOutputFile<T>::finish()
+{
+    typedef coefficient_serialization<T> format;
+
+    size_t count = this->m_size;
+    const T* coefficients = this->data();
+    while (count > 0 && coefficients[count - 1] == id_additive<T>::value)
+        --count;
+
+    PolynomialHeader header;
+    header.version = polynomial_format_version;
+    header.type = static_cast<uint8_t>(format::native_type);
+    header.flags = PolynomialHeader::native;
+    header.width = static_cast<uint8_t>(sizeof(T));
+    header.modulus = format::modulus();
+    header.degree = count == 0 ? 0 : count - 1;
+    header.count = count;
+    header.encode(this->m_file.data());
+
+    if (count < this->m_size)
+        this->m_file.truncate(PolynomialHeader::size + count * sizeof(T));
+    this->m_size = count;
+
+    return PolynomialView<T>(std::move(this->m_file));
+}
+
+// a * b, written to the file at the given path
+template<typename T>
+PolynomialView<T> multiply(const PolynomialView<T>& a, const PolynomialView<T>& b, const std::string& path)
+{
+    if (a.isNull() || b.isNull())
+        return PolynomialOutputFile<T>(path, 0).finish();
+
+    PolynomialOutputFile<T> product(path, a.size() + b.size() - 1);
+    polynomial_multiplier<T>::multiply(a.data(), a.size(), b.data(), b.size(), product.data());
+    return product.finish();
+}
+
+// The quotient and the remainder of a / b, written to the files at the given paths (like Polynomial<T>::divide).
+// Returns false if b is the nullpolynomial (and writes nothing then).
+template<typename T>
+bool divide(const PolynomialView<T>& a, const PolynomialView<T>& b, const std::string& quotient_path,
+    const std::string& remainder_path, PolynomialView<T>& quotient, PolynomialView<T>& remainder)
+{
+    if (b.isNull())
+        return false;
+
+    const size_t n = a.size();
+    const size_t m = b.size();
+    if (n < m)
+    {
+        // a = 0 * b + a
+        PolynomialOutputFile<T> rest(remainder_path, n);
+        std::copy(a.data(), a.data() + n, rest.data());
+        quotient = PolynomialOutputFile<T>(quotient_path, 0).finish();
+        remainder = rest.finish();
+        return true;
+    }
+
+    std::vector<size_t> divisor_powers;
+    const bool sparse_divisor = sparse_divisor_powers(b.data(), m, divisor_powers);
+    if (!sparse_divisor && use_newton_division<T>(n - m + 1, m, b.data()[m - 1]))
+    {
+        // (See PolynomialDivision.hpp. The results are computed in memory, and copied to the files.)
+        std::vector<T> quotient_coefficients, remainder_coefficients;
+        newton_divide(a.data(), n, b.data(), m, quotient_coefficients, remainder_coefficients);
+
+        PolynomialOutputFile<T> q(quotient_path, quotient_coefficients.size());
+        std::copy(quotient_coefficients.begin(), quotient_coefficients.end(), q.data());
+        quotient_coefficients = std::vector<T>();
+
+        PolynomialOutputFile<T> r(remainder_path, remainder_coefficients.size());
+        std::copy(remainder_coefficients.begin(), remainder_coefficients.end(), r.data());
+
+        quotient = q.finish();
+        remainder = r.finish();
+        return true;
+    }
+
+    // The long division works in the remainder file, which starts as a copy of a.
+    PolynomialOutputFile<T> q(quotient_path, n - m + 1);
+    PolynomialOutputFile<T> r(remainder_path, n);
+    std::copy(a.data(), a.data() + n, r.data());
+    long_divide(r.data(), n, b.data(), m, sparse_divisor, divisor_powers, q.data());
+
+    quotient = q.finish();
+    remainder = r.finish();
+    return true;
+}
+
+#endif // _POLYNOMIAL_VIEW_H
@@ -1,10 +1,18 @@
 #ifndef _RESIDUE_H
 #define _RESIDUE_H
 
+#include <cstdint>
 #include <stdexcept>
 #include <sstream>
 #include <vector>
+#include "BatchThreadState.hpp"
+#include "CoefficientSerialization.hpp"
+#include "CoefficientText.hpp"
 #include "EuclideanAlgorithm.hpp"
+#include "inverse_wrapper.hpp"
+#include "Instrumentation.hpp"
+#include "Montgomery.hpp"
+#include "NTT.hpp"
 
 class Residue
 {
@@ -19,6 +27,10 @@ class Residue
         long subtract(const long& a, const long& b) const;
         long multiply(const long& a, const long& b) const;
 
+        // Solve b * x = a in the residue class (that is: calculate a / b).
+        // Throws std::invalid_argument if there are no solutions.
+        long divide(const long& a, const long& b) const;
+
         // Calculate the modulo of the given number in the residue class
         long calcMod(const long& a) const;
 
@@ -37,27 +49,149 @@ long Residue::modulo() const
 }
 
 // Addition (subtraction) and multiplication is compatible with the equivalence classes
+// (The operands are reduced first, so that nothing overflows for moduli up to 2^63.)
 long Residue::add(const long& a, const long& b) const
 {
-    return this->calcMod(a + b);
+    const long x = this->calcMod(a);
+    const long y = this->calcMod(b);
+    return x >= this->m_modulo - y ? x - (this->m_modulo - y) : x + y;
 }
 
 long Residue::subtract(const long& a, const long& b) const
 {
-    return this->calcMod(a - b);
+    const long x = this->calcMod(a);
+    const long y = this->calcMod(b);
+    return x >= y ? x - y : x + (this->m_modulo - y);
 }
 
 long Residue::multiply(const long& a, const long& b) const
 {
-    return this->calcMod(a * b);
+    // The product of the reduced operands needs 128 bits.
+    const __int128 product = static_cast<__int128>(this->calcMod(a)) * this->calcMod(b);
+    return static_cast<long>(product % this->m_modulo);
+}
+
+long Residue::divide(const long& a_orig, const long& b_orig) const
+{
+    // Consider 5 : 2 = ? (mod 7)
+    // (So we call the / operator as 5/2 (on ResidueNum<7>).
+    // The answer is 6, because 6 * 2 = 12 ==congruent== 5 (mod 7).
+    //
+    // So basically, 2x === 5 (mod 7) needs a solution for x. The solution will be 6's congruence class.
+    //               bx === a (mod m)
+
+    // Reduce a and b mod m if they are not.
+    // Swap the operands because 5/2 actually means solving 2x === 5 (mod M)
+    const long a = this->calcMod(b_orig);
+    const long b = this->calcMod(a_orig);
+
+    // Use extended euclidean algorithm to find solutions p and q for
+    // a * p + m * q = gcd(a, m)
+    EEuclideanResult<long> eer = extended_euclidean<long>(a, this->m_modulo);
+    // The result's X member is our 'p' variable for this operation.
+
+    // If gcd(a, M) does not divide b then there are no solutions
+    if (b % eer.gcd != 0)
+    {
+        std::stringstream errormessage;
+        errormessage << "gcd(" << eer.a << ", " << this->m_modulo << ") = " << eer.gcd;
+        errormessage << " does not divide right-hand operand (b) " << b << " -> no solutions.";
+
+        throw std::invalid_argument(errormessage.str());
+    }
+
+    // The solution is given by the formula
+    //          b * p
+    // x0 = -------------  (mod m)
+    //       gcd(a, m)
+    // (gcd(a, m) divides b, so this is (b / gcd) * p, whose product needs 128 bits before the reduction.)
+    long x0 = static_cast<long>(static_cast<__int128>(b / eer.gcd) * eer.x % this->m_modulo);
+
+    // Normalise the result to be a positive number
+    return this->calcMod(x0);
 }
 
 long Residue::calcMod(const long& a) const
 {
-    // Calculate the modulo for the given number
-    return (a % this->m_modulo + this->m_modulo) % this->m_modulo;
+    // Calculate the modulo for the given number (% keeps the sign of a negative number)
+    const long result = a % this->m_modulo;
+    return result < 0 ? result + this->m_modulo : result;
+}
+
+// Moduli up to this have the inverse of every number precomputed in a table.
+inline constexpr long residue_inverse_table_limit = 1 << 16;
+
+// The inverse of every number modulo mod (0 where there is none)
+inline std::vector<long> residue_inverse_table(const long mod)
+{
+    std::vector<long> inverses(mod, 0);
+    if (mod < 2)
+        return inverses;
+
+    inverses[1] = 1;
+    if (ntt_is_prime(mod))
+    {
+        // m = (m / i) * i + m % i, so i^-1 = -(m / i) * (m % i)^-1, and m % i < i is already known.
+        for (long i = 2; i < mod; ++i)
+            inverses[i] = (mod - (mod / i) * inverses[mod % i] % mod) % mod;
+    }
+    else
+    {
+        for (long i = 2; i < mod; ++i)
+        {
+            EEuclideanResult<long> eer = extended_euclidean<long>(i, mod);
+            if (eer.gcd == 1)
+                inverses[i] = (eer.x % mod + mod) % mod;
+        }
+    }
+
+    return inverses;
 }
 
+// The arithmetic of ResidueNum<M> on the stored representation of its numbers.
+// Odd moduli keep the numbers in Montgomery form (see Montgomery.hpp), so products need no division,
+// and every constant of the form is computed at compile time. Even moduli, where the Montgomery reduction
+// doesn't work, keep the numbers plain and reduce the products by %.
+// Either way the products have 128 bits, so every modulus up to 2^63 is correct.
+template<long M, bool = (M % 2 != 0)>
+struct residue_arithmetic
+{
+    static constexpr Montgomery64 field = Montgomery64(M);
+
+    // Conversion of a reduced number from and to the representation
+    static constexpr uint64_t fromNumber(const uint64_t a) { return field.toMontgomery(a); }
+    static constexpr uint64_t toNumber(const uint64_t a) { return field.fromMontgomery(a); }
+
+    static constexpr uint64_t add(const uint64_t a, const uint64_t b) { return field.add(a, b); }
+    static constexpr uint64_t subtract(const uint64_t a, const uint64_t b) { return field.subtract(a, b); }
+    static constexpr uint64_t multiply(const uint64_t a, const uint64_t b) { return field.multiply(a, b); }
+};
+
+template<long M>
+struct residue_arithmetic<M, false>
+{
+    static constexpr uint64_t modulo = M;
+
+    static constexpr uint64_t fromNumber(const uint64_t a) { return a; }
+    static constexpr uint64_t toNumber(const uint64_t a) { return a; }
+
+    static constexpr uint64_t add(const uint64_t a, const uint64_t b)
+    {
+        const uint64_t sum = a + b; // No overflow, as M < 2^63
+        return sum >= modulo ? sum - modulo : sum;
+    }
+
+    static constexpr uint64_t subtract(const uint64_t a, const uint64_t b)
+    {
+        return a >= b ? a - b : a + modulo - b;
+    }
+
+    static constexpr uint64_t multiply(const uint64_t a, const uint64_t b)
+    {
+        return static_cast<uint64_t>(static_cast<unsigned __int128>(a) * b % modulo);
+    }
+};
+
 // Represent a number in a residue/congruence system
 // M is the modulo
 template<long M>
@@ -66,10 +200,13 @@ class ResidueNum
     public:
         ResidueNum<M>();
         ResidueNum<M>(const long num);
-        ResidueNum<M>(const ResidueNum<M>& num);
+        ResidueNum<M>(const ResidueNum<M>& num) = default; // Trivially copyable, so buffers of numbers are copied as memory
 
         long number() const;
 
+        // The multiplicative inverse. Throws std::invalid_argument if the number is not invertible.
+        ResidueNum<M> inverse() const;
+
         template<long N>
         friend ResidueNum<N> operator + (const ResidueNum<N>& a, const ResidueNum<N>& b);
         template<long N>
@@ -98,158 +235,164 @@ class ResidueNum
         template<long N>
         friend bool operator != (const ResidueNum<N>& a, const ResidueNum<N>& b);
 
+        template<typename U, typename S>
+        friend std::ostream& operator << (std::ostream& o, const Polynomial<U, S>& poly);
+
+        // The vectorised kernels work on the representation (see SimdKernels.hpp)
         template<typename U>
-        friend std::ostream& operator << (std::ostream& o, const Polynomial<U>& poly);
+        friend struct coefficient_kernels;
     private:
-        long m_number;
-        //static const long m_modulo = M;
+        typedef residue_arithmetic<M> arithmetic;
+
+        // The number in the representation of residue_arithmetic<M> (Montgomery form for odd moduli)
+        uint64_t m_number;
+
+        // Wrap a number which is already in the representation
+        static ResidueNum<M> fromRepresentation(const uint64_t representation)
+        {
+            ResidueNum<M> result;
+            result.m_number = representation;
+            return result;
+        }
+
+        // The inverse of every number, from and to the representation (0 where there is none).
+        // Only for moduli up to residue_inverse_table_limit; built at the first use.
+        static const std::vector<uint64_t>& inverseTable();
 };
 
 template<long M>
 ResidueNum<M>::ResidueNum()
 {
-    this->m_number = 0;
+    this->m_number = 0; // 0 is 0 in Montgomery form too
 }
 
 template<long M>
 ResidueNum<M>::ResidueNum(const long num)
 {
-    Residue r(M);
-    this->m_number = r.calcMod(num);
-}
+    long reduced = num % M;
+    if (reduced < 0)
+        reduced += M;
 
-template<long M>
-ResidueNum<M>::ResidueNum(const ResidueNum<M>& num)
-{
-    this->m_number = num.m_number;
+    this->m_number = arithmetic::fromNumber(static_cast<uint64_t>(reduced));
 }
 
 template<long M>
 long ResidueNum<M>::number() const
 {
-    return this->m_number;
+    return static_cast<long>(arithmetic::toNumber(this->m_number));
 }
 
+// The operations work on the representation directly: no reduction by % is needed.
 template<long M>
 ResidueNum<M> operator + (const ResidueNum<M>& a, const ResidueNum<M>& b)
 {
-    Residue r(M);
-
-    ResidueNum<M> c(r.add(a.m_number, b.m_number));
-    return c;
+    return ResidueNum<M>::fromRepresentation(residue_arithmetic<M>::add(a.m_number, b.m_number));
 }
 
 template<long M>
 ResidueNum<M> operator - (const ResidueNum<M>& a, const ResidueNum<M>& b)
 {
-    Residue r(M);
-
-    ResidueNum<M> c(r.subtract(a.m_number, b.m_number));
-    return c;
+    return ResidueNum<M>::fromRepresentation(residue_arithmetic<M>::subtract(a.m_number, b.m_number));
 }
 
 template<long M>
 ResidueNum<M> operator * (const ResidueNum<M>& a, const ResidueNum<M>& b)
 {
-    Residue r(M);
+    return ResidueNum<M>::fromRepresentation(residue_arithmetic<M>::multiply(a.m_number, b.m_number));
+}
 
-    ResidueNum<M> c(r.multiply(a.m_number, b.m_number));
-    return c;
+template<long M>
+const std::vector<uint64_t>& ResidueNum<M>::inverseTable()
+{
+    static const std::vector<uint64_t> table = []()
+    {
+        const std::vector<long> inverses = residue_inverse_table(M);
+        std::vector<uint64_t> representations(M, 0);
+        for (long i = 0; i < M; ++i)
+            representations[arithmetic::fromNumber(i)] = arithmetic::fromNumber(inverses[i]);
+        return representations;
+    }();
+
+    return table;
 }
 
 template<long M>
-ResidueNum<M> operator / (const ResidueNum<M>& a_orig, const ResidueNum<M>& b_orig)
+ResidueNum<M> ResidueNum<M>::inverse() const
 {
-    // Consider 5 : 2 = ? (mod 7)
-    // (So we call the / operator as 5/2 (on ResidueNum<7>).
-    // The answer is 6, because 6 * 2 = 12 ==congruent== 5 (mod 7).
-    //
-    // So basically, 2x === 5 (mod 7) needs a solution for x. The solution will be 6's congruence class.
-    //               bx === a (mod m)
+    Instrumentation::inversions(1);
+    if constexpr (M <= residue_inverse_table_limit)
+    {
+        const uint64_t inverse = inverseTable()[this->m_number];
+        if (inverse != 0)
+            return fromRepresentation(inverse);
+    }
 
-    // Reduce a and b mod m if they are not.
+    // 1 / this, by the extended Euclidean algorithm (which also reports the numbers without an inverse)
     Residue modOp(M);
-    
-    // Swap the operands because 5/2 actually means solving 2x === 5 (mod M)
-    ResidueNum<M> a(modOp.calcMod(b_orig.number()));
-    ResidueNum<M> b(modOp.calcMod(a_orig.number()));
+    return ResidueNum<M>(modOp.divide(1, this->number()));
+}
 
-    // Use extended euclidean algorithm to find solutions p and q for
-    // a * p + m * q = gcd(a, m)
-    EEuclideanResult<long> eer = extended_euclidean<long>(a.number(), M);
-    // The result's X member is our 'p' variable for this operation.
+template<long M>
+ResidueNum<M> operator / (const ResidueNum<M>& a_orig, const ResidueNum<M>& b_orig)
+{
+    Instrumentation::inversions(1);
 
-    // If gcd(a, M) does not divide b then there are no solutions
-    if (b.number() % eer.gcd != 0)
+    // Small moduli look the inverse up, so that the division is just a multiplication.
+    if constexpr (M <= residue_inverse_table_limit)
     {
-        std::stringstream errormessage;
-        errormessage << "gcd(" << eer.a << ", " << M << ") = " << eer.gcd;
-        errormessage << " does not divide right-hand operand (b) " << b.number() << " -> no solutions.";
-
-        throw std::invalid_argument(errormessage.str());
+        const uint64_t inverse = ResidueNum<M>::inverseTable()[b_orig.m_number];
+        if (inverse != 0)
+            return ResidueNum<M>::fromRepresentation(residue_arithmetic<M>::multiply(a_orig.m_number, inverse));
     }
 
-    // The solution is given by the formula
-    //          b * p
-    // x0 = -------------  (mod m)
-    //       gcd(a, m)
-    long x0 = (b.number() * eer.x) / eer.gcd;
-
-    // Normalise the result to be a positive number
-    long result_Num = modOp.calcMod(x0);
-    return ResidueNum<M>(result_Num);
+    // (See Residue::divide, which also solves the divisions by numbers without an inverse, if they have a solution.)
+    Residue modOp(M);
+    return ResidueNum<M>(modOp.divide(a_orig.number(), b_orig.number()));
 }
 
 template<long M>
 ResidueNum<M>& operator += (ResidueNum<M>& current, const ResidueNum<M>& add)
 {
-    Residue r(M);
-
-    ResidueNum<M> c(r.add(current.m_number, add.m_number));
-    current = c;
+    current.m_number = residue_arithmetic<M>::add(current.m_number, add.m_number);
     return current;
 }
 
+// The ordering is the one of the reduced numbers (the Montgomery form doesn't keep it)...
 template<long M>
 bool operator < (const ResidueNum<M>& a, const ResidueNum<M>& b)
 {
-    Residue r(M);
-    return r.calcMod(a.m_number) < r.calcMod(b.m_number);
+    return a.number() < b.number();
 }
 
 template<long M>
 bool operator <= (const ResidueNum<M>& a, const ResidueNum<M>& b)
 {
-    Residue r(M);
-    return r.calcMod(a.m_number) <= r.calcMod(b.m_number);
+    return a.number() <= b.number();
 }
 
 template<long M>
 bool operator > (const ResidueNum<M>& a, const ResidueNum<M>& b)
 {
-    Residue r(M);
-    return r.calcMod(a.m_number) > r.calcMod(b.m_number);
+    return a.number() > b.number();
 }
 
 template<long M>
 bool operator >= (const ResidueNum<M>& a, const ResidueNum<M>& b)
 {
-    Residue r(M);
-    return r.calcMod(a.m_number) >= r.calcMod(b.m_number);
+    return a.number() >= b.number();
 }
 
+// ... but the representation is unique, so equality can be checked on it.
 template<long M>
 bool operator == (const ResidueNum<M>& a, const ResidueNum<M>& b)
 {
-    Residue r(M);
-    return r.calcMod(a.m_number) == r.calcMod(b.m_number);
+    return a.m_number == b.m_number;
 }
 
 template<long M>
 bool operator != (const ResidueNum<M>& a, const ResidueNum<M>& b)
 {
-    Residue r(M);
-    return r.calcMod(a.m_number) != r.calcMod(b.m_number);
+    return a.m_number != b.m_number;
 }
 
 template<long M>
@@ -259,6 +402,223 @@ std::ostream& operator << (std::ostream& o, const ResidueNum<M>& num)
     return o;
 }
 
+
+// A modulus chosen at runtime, for the RuntimeResidueNum numbers (see below).
+// Besides the modulus, the context keeps the constants of the fast arithmetic precomputed:
+// the Barrett constant, which turns the reduction of a product into two multiplications,
+// and the NTT engine of the modulus.
+class ResidueContext : public Residue
+{
+    public:
+        // The modulus has to be in [2, 2^32), so that the product of two residues fits in 64 bits.
+        explicit ResidueContext(const long mod);
+
+        // Do +, - and * operation on reduced numbers (that is: in [0, modulo))
+        long add(const long& a, const long& b) const;
+        long subtract(const long& a, const long& b) const;
+        long multiply(const long& a, const long& b) const;
+
+        // Barrett reduction: a (mod n) without a division
+        long reduce(const uint64_t a) const;
+
+        // The multiplicative inverse of a reduced number. Throws std::invalid_argument if there is none.
+        // (Looked up in a table for moduli up to residue_inverse_table_limit.)
+        long inverse(const long& a) const;
+
+        // Solve b * x = a (see Residue::divide), for reduced numbers
+        long divide(const long& a, const long& b) const;
+
+        const NTTEngine& engine() const { return this->m_engine; }
+
+        // The context of the RuntimeResidueNum operations on the calling thread.
+        // Throws std::logic_error if there is none.
+        static const ResidueContext& current();
+
+        // Make a context the current one of the calling thread while the scope lives.
+        // (Scopes can be nested, the previous context is restored at the end.)
+        class Scope
+        {
+            public:
+                explicit Scope(const ResidueContext& context) : m_previous(ResidueContext::s_current)
+                {
+                    ResidueContext::s_current = &context;
+                }
+
+                ~Scope() { ResidueContext::s_current = this->m_previous; }
+
+                Scope(const Scope&) = delete;
+                Scope& operator = (const Scope&) = delete;
+
+            private:
+                const ResidueContext* m_previous;
+        };
+
+    private:
+        uint64_t m_barrett; // floor((2^64 - 1) / n)
+        NTTEngine m_engine;
+        std::vector<long> m_inverses; // Empty for moduli above the table limit
+
+        static inline thread_local const ResidueContext* s_current = nullptr;
+};
+
+inline ResidueContext::ResidueContext(const long mod)
+    : Residue(mod), m_barrett(0), m_engine(mod < 2 ? 2 : static_cast<uint64_t>(mod))
+{
+    if (mod < 2 || mod > 0xFFFFFFFFL)
+    {
+        std::stringstream errormessage;
+        errormessage << "The modulo " << mod << " of a residue context must be in [2, 2^32).";
+
+        throw std::invalid_argument(errormessage.str());
+    }
+
+    this->m_barrett = UINT64_MAX / static_cast<uint64_t>(mod);
+
+    if (mod <= residue_inverse_table_limit)
+        this->m_inverses = residue_inverse_table(mod);
+}
+
+inline long ResidueContext::add(const long& a, const long& b) const
+{
+    const long sum = a + b;
+    return sum >= this->modulo() ? sum - this->modulo() : sum;
+}
+
+inline long ResidueContext::subtract(const long& a, const long& b) const
+{
+    return a >= b ? a - b : a + this->modulo() - b;
+}
+
+inline long ResidueContext::multiply(const long& a, const long& b) const
+{
+    return this->reduce(static_cast<uint64_t>(a) * static_cast<uint64_t>(b));
+}
+
+inline long ResidueContext::reduce(const uint64_t a) const
+{
+    // The high half of a * floor((2^64 - 1) / n) underestimates a / n by at most 2.
+    const uint64_t modulo = static_cast<uint64_t>(this->modulo());
+    const uint64_t quotient = static_cast<uint64_t>((static_cast<unsigned __int128>(a) * this->m_barrett) >> 64);
+
+    uint64_t result = a - quotient * modulo;
+    while (result >= modulo)
+        result -= modulo;
+
+    return static_cast<long>(result);
+}
+
+inline long ResidueContext::inverse(const long& a) const
+{
+    if (!this->m_inverses.empty() && this->m_inverses[a] != 0)
+        return this->m_inverses[a];
+
+    return Residue::divide(1, a);
+}
+
+inline long ResidueContext::divide(const long& a, const long& b) const
+{
+    if (!this->m_inverses.empty() && this->m_inverses[b] != 0)
+        return this->multiply(a, this->m_inverses[b]);
+
+    return Residue::divide(a, b);
+}
+
+inline const ResidueContext& ResidueContext::current()
+{
+    if (s_current == nullptr)
+        throw std::logic_error("No residue context is set for RuntimeResidueNum (see ResidueContext::Scope).");
+
+    return *s_current;
+}
+
+// Represent a number in a residue/congruence system whose modulo is only known at runtime.
+// The modulo is the one of the current ResidueContext of the thread, which is shared by every number:
+// the numbers only store their value, so they are as small and fast as ResidueNum<M>.
+// (Numbers from different contexts must not be mixed.)
+class RuntimeResidueNum
+{
+    public:
+        RuntimeResidueNum() : m_number(0) {}
+        RuntimeResidueNum(const long num);
+
+        // Wrap a number which is already reduced (in [0, modulo)) without a context.
+        static RuntimeResidueNum fromReduced(const long num)
+        {
+            RuntimeResidueNum result;
+            result.m_number = num;
+            return result;
+        }
+
+        long number() const { return this->m_number; }
+
+        // The multiplicative inverse. Throws std::invalid_argument if the number is not invertible.
+        RuntimeResidueNum inverse() const
+        {
+            Instrumentation::inversions(1);
+            return fromReduced(ResidueContext::current().inverse(this->m_number));
+        }
+
+        friend RuntimeResidueNum operator + (const RuntimeResidueNum& a, const RuntimeResidueNum& b);
+        friend RuntimeResidueNum operator - (const RuntimeResidueNum& a, const RuntimeResidueNum& b);
+        friend RuntimeResidueNum operator * (const RuntimeResidueNum& a, const RuntimeResidueNum& b);
+        friend RuntimeResidueNum operator / (const RuntimeResidueNum& a, const RuntimeResidueNum& b);
+
+        // This is needed for RuntimeResidueNum to work in Polynomial<> context
+        friend RuntimeResidueNum& operator += (RuntimeResidueNum& current, const RuntimeResidueNum& add);
+
+    private:
+        long m_number;
+};
+
+inline RuntimeResidueNum::RuntimeResidueNum(const long num)
+{
+    const ResidueContext& context = ResidueContext::current();
+    this->m_number = (num >= 0 ? context.reduce(static_cast<uint64_t>(num)) : context.calcMod(num));
+}
+
+inline RuntimeResidueNum operator + (const RuntimeResidueNum& a, const RuntimeResidueNum& b)
+{
+    return RuntimeResidueNum::fromReduced(ResidueContext::current().add(a.m_number, b.m_number));
+}
+
+inline RuntimeResidueNum operator - (const RuntimeResidueNum& a, const RuntimeResidueNum& b)
+{
+    return RuntimeResidueNum::fromReduced(ResidueContext::current().subtract(a.m_number, b.m_number));
+}
+
+inline RuntimeResidueNum operator * (const RuntimeResidueNum& a, const RuntimeResidueNum& b)
+{
+    return RuntimeResidueNum::fromReduced(ResidueContext::current().multiply(a.m_number, b.m_number));
+}
+
+inline RuntimeResidueNum operator / (const RuntimeResidueNum& a, const RuntimeResidueNum& b)
+{
+    Instrumentation::inversions(1);
+
+    // (See ResidueContext::divide.)
+    return RuntimeResidueNum::fromReduced(ResidueContext::current().divide(a.m_number, b.m_number));
+}
+
+inline RuntimeResidueNum& operator += (RuntimeResidueNum& current, const RuntimeResidueNum& add)
+{
+    current = current + add;
+    return current;
+}
+
+// The numbers are always reduced, so they can be compared directly.
+inline bool operator < (const RuntimeResidueNum& a, const RuntimeResidueNum& b) { return a.number() < b.number(); }
+inline bool operator <= (const RuntimeResidueNum& a, const RuntimeResidueNum& b) { return a.number() <= b.number(); }
+inline bool operator > (const RuntimeResidueNum& a, const RuntimeResidueNum& b) { return a.number() > b.number(); }
+inline bool operator >= (const RuntimeResidueNum& a, const RuntimeResidueNum& b) { return a.number() >= b.number(); }
+inline bool operator == (const RuntimeResidueNum& a, const RuntimeResidueNum& b) { return a.number() == b.number(); }
+inline bool operator != (const RuntimeResidueNum& a, const RuntimeResidueNum& b) { return a.number() != b.number(); }
+
+inline std::ostream& operator << (std::ostream& o, const RuntimeResidueNum& num)
+{
+    o << num.number();
+    return o;
+}
+
 #ifdef _ADD_MULT_IDENTITY_H
 // Declare the additive and multiplicative inverses for residue numbers
 template<long M> struct id_multiplicative_exists<ResidueNum<M>> : id_multiplicative_known{};
@@ -268,8 +628,30 @@ template<long M> ResidueNum<M> const id_multiplicative<ResidueNum<M>>::value = R
 template<long M> struct id_additive_exists<ResidueNum<M>> : id_additive_known{};
 template<long M> struct id_additive<ResidueNum<M>> { static ResidueNum<M> const value; };
 template<long M> ResidueNum<M> const id_additive<ResidueNum<M>>::value = ResidueNum<M>(0);
+
+// 0 and 1 are reduced for every context, so they don't need one.
+template<> struct id_multiplicative_exists<RuntimeResidueNum> : id_multiplicative_known{};
+template<> struct id_multiplicative<RuntimeResidueNum> { static inline RuntimeResidueNum const value = RuntimeResidueNum::fromReduced(1); };
+
+template<> struct id_additive_exists<RuntimeResidueNum> : id_additive_known{};
+template<> struct id_additive<RuntimeResidueNum> { static inline RuntimeResidueNum const value = RuntimeResidueNum::fromReduced(0); };
 #endif // _ADD_MULT_IDENTITY_H
 
+// Residue numbers can be divided by multiplying with the inverse (see inverse_wrapper.hpp).
+template<long M>
+struct multiplicative_inverse<ResidueNum<M>>
+{
+    static const bool known = true;
+    static ResidueNum<M> inverse(const ResidueNum<M>& val) { return val.inverse(); }
+};
+
+template<>
+struct multiplicative_inverse<RuntimeResidueNum>
+{
+    static const bool known = true;
+    static RuntimeResidueNum inverse(const RuntimeResidueNum& val) { return val.inverse(); }
+};
+
 #ifdef _ABSVALUE_WRAPPER_H
 // Declare the absolute value function for residue numbers.
 template<long M>
@@ -278,11 +660,258 @@ struct abs_value<ResidueNum<M>>
     static const bool known = true;
     static ResidueNum<M> abs(ResidueNum<M> val)
     {
-        Residue r(M);
-        long num = r.calcMod(val.number());
-        ResidueNum<M> n(num);
-        return n;
+        // The numbers are always reduced.
+        return val;
+    }
+};
+
+template<>
+struct abs_value<RuntimeResidueNum>
+{
+    static const bool known = true;
+    static RuntimeResidueNum abs(RuntimeResidueNum val)
+    {
+        // The numbers are always reduced.
+        return val;
     }
 };
 #endif // _ABSVALUE_WRAPPER_H
+
+#ifdef _POLYNOMIAL_MULTIPLY_H
+// Polynomials over residue numbers are multiplied by number-theoretic transform above the threshold.
+// (R is a residue number type, its numbers are reduced modulo the modulo of the engine.)
+template<typename R>
+void residue_polynomial_multiply(const NTTEngine& engine, const R* a, const size_t n, const R* b, const size_t m, R* out)
+{
+    if (std::min(n, m) >= polynomial_thresholds::ntt)
+    {
+        std::vector<uint64_t> a_numbers(n);
+        std::vector<uint64_t> b_numbers(m);
+        std::vector<uint64_t> product(n + m - 1);
+        for (size_t i = 0; i < n; ++i)
+            a_numbers[i] = a[i].number();
+        for (size_t i = 0; i < m; ++i)
+            b_numbers[i] = b[i].number();
+
+        if (engine.multiply(a_numbers.data(), n, b_numbers.data(), m, product.data()))
+        {
+            for (size_t i = 0; i < product.size(); ++i)
+                out[i] = R(static_cast<long>(product[i]));
+            return;
+        }
+    }
+
+    // Too short to be worth it, or too long for the transform
+    karatsuba_multiply(a, n, b, m, out);
+}
+
+template<long M>
+struct polynomial_multiplier<ResidueNum<M>>
+{
+    static void multiply(const ResidueNum<M>* a, const size_t n, const ResidueNum<M>* b, const size_t m, ResidueNum<M>* out)
+    {
+        // The engine finds out once if M is a prime suitable for the transform, or the CRT is needed.
+        static const NTTEngine engine(M);
+        residue_polynomial_multiply(engine, a, n, b, m, out);
+    }
+};
+
+template<>
+struct polynomial_multiplier<RuntimeResidueNum>
+{
+    static void multiply(const RuntimeResidueNum* a, const size_t n, const RuntimeResidueNum* b, const size_t m, RuntimeResidueNum* out)
+    {
+        // The context has set up the engine of its modulo.
+        residue_polynomial_multiply(ResidueContext::current().engine(), a, n, b, m, out);
+    }
+};
+#endif // _POLYNOMIAL_MULTIPLY_H
+
+#ifdef _SIMD_KERNELS_H
+// The element-wise passes over residue numbers work on the representation of the numbers:
+// a buffer of ResidueNum<M> is a buffer of reduced 64-bit words (Montgomery form for odd moduli).
+template<long M>
+struct coefficient_kernels<ResidueNum<M>>
+{
+    static_assert(sizeof(ResidueNum<M>) == sizeof(uint64_t), "ResidueNum<M> has to hold nothing but its representation");
+
+    static void add(ResidueNum<M>* a, const ResidueNum<M>* b, const size_t n)
+    {
+        Instrumentation::additions(n);
+        simd_residue_add(representation(a), representation(b), n, M);
+    }
+
+    static void subtract(ResidueNum<M>* a, const ResidueNum<M>* b, const size_t n)
+    {
+        Instrumentation::additions(n);
+        simd_residue_subtract(representation(a), representation(b), n, M);
+    }
+
+    static void scale(ResidueNum<M>* a, const size_t n, const ResidueNum<M>& c)
+    {
+        Instrumentation::multiplications(n);
+
+        if constexpr (M % 2 == 1)
+            simd_montgomery_scale(representation(a), n, c.m_number, residue_arithmetic<M>::field);
+        else
+        {
+            // (Even moduli are reduced by %, there is no vector version of that.)
+            for (size_t i = 0; i < n; ++i)
+                a[i] = a[i] * c;
+        }
+    }
+
+    static void axpy(ResidueNum<M>* a, const ResidueNum<M>* b, const size_t n, const ResidueNum<M>& c)
+    {
+        Instrumentation::multiplications(n);
+        Instrumentation::additions(n);
+
+        if constexpr (M % 2 == 1)
+            simd_montgomery_axpy(representation(a), representation(b), n, c.m_number, residue_arithmetic<M>::field);
+        else
+        {
+            for (size_t i = 0; i < n; ++i)
+                a[i] = a[i] + c * b[i];
+        }
+    }
+
+    private:
+        static uint64_t* representation(ResidueNum<M>* numbers) { return reinterpret_cast<uint64_t*>(numbers); }
+        static const uint64_t* representation(const ResidueNum<M>* numbers) { return reinterpret_cast<const uint64_t*>(numbers); }
+};
+
+// Runtime residue numbers are reduced longs: only addition and subtraction are vectorised (Barrett
+// reduction has no vector version here).
+template<>
+struct coefficient_kernels<RuntimeResidueNum>
+{
+    static_assert(sizeof(RuntimeResidueNum) == sizeof(uint64_t), "RuntimeResidueNum has to hold nothing but its number");
+
+    static void add(RuntimeResidueNum* a, const RuntimeResidueNum* b, const size_t n)
+    {
+        Instrumentation::additions(n);
+        simd_residue_add(reinterpret_cast<uint64_t*>(a), reinterpret_cast<const uint64_t*>(b), n, ResidueContext::current().modulo());
+    }
+
+    static void subtract(RuntimeResidueNum* a, const RuntimeResidueNum* b, const size_t n)
+    {
+        Instrumentation::additions(n);
+        simd_residue_subtract(reinterpret_cast<uint64_t*>(a), reinterpret_cast<const uint64_t*>(b), n, ResidueContext::current().modulo());
+    }
+
+    static void scale(RuntimeResidueNum* a, const size_t n, const RuntimeResidueNum& c)
+    {
+        Instrumentation::multiplications(n);
+
+        const ResidueContext& context = ResidueContext::current();
+        for (size_t i = 0; i < n; ++i)
+            a[i] = RuntimeResidueNum::fromReduced(context.multiply(a[i].number(), c.number()));
+    }
+
+    static void axpy(RuntimeResidueNum* a, const RuntimeResidueNum* b, const size_t n, const RuntimeResidueNum& c)
+    {
+        Instrumentation::multiplications(n);
+        Instrumentation::additions(n);
+
+        const ResidueContext& context = ResidueContext::current();
+        for (size_t i = 0; i < n; ++i)
+            a[i] = RuntimeResidueNum::fromReduced(context.add(a[i].number(), context.multiply(c.number(), b[i].number())));
+    }
+};
+#endif // _SIMD_KERNELS_H
+
+// The workers of a batch compute in the context of the calling thread (see BatchThreadState.hpp).
+template<>
+struct batch_thread_state<RuntimeResidueNum>
+{
+    const ResidueContext* context;
+
+    static batch_thread_state<RuntimeResidueNum> capture() { return { &ResidueContext::current() }; }
+
+    struct Scope
+    {
+        ResidueContext::Scope scope;
+
+        explicit Scope(const batch_thread_state<RuntimeResidueNum>& state) : scope(*state.context) {}
+    };
+};
+
+// Residues are serialized as their number in [0, M), in the bytes the modulus needs (see CoefficientSerialization.hpp).
+template<long M>
+struct coefficient_serialization<ResidueNum<M>>
+{
+    static const serialized_coefficient_type type = serialized_residue;
+    static const serialized_coefficient_type native_type = (M % 2 == 1 ? serialized_montgomery : serialized_residue);
+
+    static uint64_t modulus() { return M; }
+    static size_t width() { return serialized_residue_width(M); }
+
+    static uint64_t pack(const ResidueNum<M>& coefficient) { return static_cast<uint64_t>(coefficient.number()); }
+
+    static ResidueNum<M> unpack(const uint64_t bits)
+    {
+        if (bits >= static_cast<uint64_t>(M))
+            throw std::invalid_argument("The serialized polynomial has a coefficient out of the range of its modulus.");
+
+        return ResidueNum<M>(static_cast<long>(bits));
+    }
+};
+
+// (Runtime residues are serialized modulo the current context, and can be read back into a ResidueNum<M>
+// of the same modulus, and the other way round.)
+template<>
+struct coefficient_serialization<RuntimeResidueNum>
+{
+    static const serialized_coefficient_type type = serialized_residue;
+    static const serialized_coefficient_type native_type = serialized_residue;
+
+    static uint64_t modulus() { return static_cast<uint64_t>(ResidueContext::current().modulo()); }
+    static size_t width() { return serialized_residue_width(modulus()); }
+
+    static uint64_t pack(const RuntimeResidueNum& coefficient) { return static_cast<uint64_t>(coefficient.number()); }
+
+    static RuntimeResidueNum unpack(const uint64_t bits)
+    {
+        if (bits >= modulus())
+            throw std::invalid_argument("The serialized polynomial has a coefficient out of the range of its modulus.");
+
+        return RuntimeResidueNum::fromReduced(static_cast<long>(bits));
+    }
+};
+
+// Residues are written as their number in [0, M), and read from any integer, which is reduced (see CoefficientText.hpp).
+template<long M>
+struct coefficient_text<ResidueNum<M>>
+{
+    static const bool known = true;
+
+    static std::to_chars_result format(char* first, char* last, const ResidueNum<M>& value) { return std::to_chars(first, last, value.number()); }
+
+    static std::from_chars_result parse(const char* first, const char* last, ResidueNum<M>& value)
+    {
+        long number = 0;
+        const std::from_chars_result read = std::from_chars(first, last, number);
+        if (read.ec == std::errc())
+            value = ResidueNum<M>(number);
+        return read;
+    }
+};
+
+// (Runtime residues are read modulo the current context.)
+template<>
+struct coefficient_text<RuntimeResidueNum>
+{
+    static const bool known = true;
+
+    static std::to_chars_result format(char* first, char* last, const RuntimeResidueNum& value) { return std::to_chars(first, last, value.number()); }
+
+    static std::from_chars_result parse(const char* first, const char* last, RuntimeResidueNum& value)
+    {
+        long number = 0;
+        const std::from_chars_result read = std::from_chars(first, last, number);
+        if (read.ec == std::errc())
+            value = RuntimeResidueNum(number);
+        return read;
+    }
+};
 #endif // _RESIDUE_H
\ No newline at end of file
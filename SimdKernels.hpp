@@ -0,0 +1,527 @@
+#ifndef _SIMD_KERNELS_H
+#define _SIMD_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include "Montgomery.hpp"
+#include "Instrumentation.hpp"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define _SIMD_X86_AVAILABLE
+#endif
+
+// Element-wise kernels for contiguous coefficient buffers: the passes of addition, subtraction,
+// multiplication by a constant and the addition of a multiple (axpy: the step of the schoolbook
+// multiplication, and of the long division with the negated member of the quotient).
+//
+// coefficient_kernels<T> is what Polynomial<T> calls. The generic one is a plain loop over the operators of T;
+// double has AVX2 and AVX-512 versions, and residue numbers have vectorised modular arithmetic on their
+// representation (see Residue.hpp). The instruction set is chosen at runtime, by what the processor supports.
+// Every kernel counts its coefficient operations in the instrumentation (see Instrumentation.hpp).
+
+enum simd_instruction_set
+{
+    simd_scalar,
+    simd_avx2,
+    simd_avx512
+};
+
+// The widest instruction set supported by the processor (found out once)
+inline simd_instruction_set simd_support()
+{
+#ifdef _SIMD_X86_AVAILABLE
+    static const simd_instruction_set support =
+        __builtin_cpu_supports("avx512f") ? simd_avx512 :
+        __builtin_cpu_supports("avx2") ? simd_avx2 : simd_scalar;
+    return support;
+#else
+    return simd_scalar;
+#endif // _SIMD_X86_AVAILABLE
+}
+
+// The element-wise passes over n coefficients. (a may be the same buffer as b.)
+// Specialise this for coefficient types which have a faster method (see Residue.hpp).
+template<typename T>
+struct coefficient_kernels
+{
+    // a = a + b
+    static void add(T* a, const T* b, const size_t n)
+    {
+        Instrumentation::additions(n);
+        for (size_t i = 0; i < n; ++i)
+            a[i] = a[i] + b[i];
+    }
+
+    // a = a - b
+    static void subtract(T* a, const T* b, const size_t n)
+    {
+        Instrumentation::additions(n);
+        for (size_t i = 0; i < n; ++i)
+            a[i] = a[i] - b[i];
+    }
+
+    // a = a * c
+    static void scale(T* a, const size_t n, const T& c)
+    {
+        Instrumentation::multiplications(n);
+        for (size_t i = 0; i < n; ++i)
+            a[i] = a[i] * c;
+    }
+
+    // a = a + c * b
+    static void axpy(T* a, const T* b, const size_t n, const T& c)
+    {
+        Instrumentation::multiplications(n);
+        Instrumentation::additions(n);
+        for (size_t i = 0; i < n; ++i)
+            a[i] = a[i] + c * b[i];
+    }
+};
+
+/* double */
+// The vector kernels round exactly like the scalar loops: a + c * b is a multiplication and an addition
+// (never fused), so the result doesn't depend on the instruction set of the processor.
+
+#ifdef _SIMD_X86_AVAILABLE
+__attribute__((target("avx2")))
+inline void simd_add_avx2(double* a, const double* b, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(a + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    for (; i < n; ++i)
+        a[i] = a[i] + b[i];
+}
+
+__attribute__((target("avx2")))
+inline void simd_subtract_avx2(double* a, const double* b, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(a + i, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    for (; i < n; ++i)
+        a[i] = a[i] - b[i];
+}
+
+__attribute__((target("avx2")))
+inline void simd_scale_avx2(double* a, const size_t n, const double c)
+{
+    const __m256d constant = _mm256_set1_pd(c);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(a + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), constant));
+    for (; i < n; ++i)
+        a[i] = a[i] * c;
+}
+
+__attribute__((target("avx2")))
+inline void simd_axpy_avx2(double* a, const double* b, const size_t n, const double c)
+{
+    const __m256d constant = _mm256_set1_pd(c);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(a + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_mul_pd(constant, _mm256_loadu_pd(b + i))));
+    for (; i < n; ++i)
+        a[i] = a[i] + c * b[i];
+}
+
+// (AVX-512 has fused multiply-add: contraction is turned off to keep the rounding of the other versions.)
+__attribute__((target("avx512f"), optimize("fp-contract=off")))
+inline void simd_add_avx512(double* a, const double* b, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_pd(a + i, _mm512_add_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    for (; i < n; ++i)
+        a[i] = a[i] + b[i];
+}
+
+__attribute__((target("avx512f"), optimize("fp-contract=off")))
+inline void simd_subtract_avx512(double* a, const double* b, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_pd(a + i, _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    for (; i < n; ++i)
+        a[i] = a[i] - b[i];
+}
+
+__attribute__((target("avx512f"), optimize("fp-contract=off")))
+inline void simd_scale_avx512(double* a, const size_t n, const double c)
+{
+    const __m512d constant = _mm512_set1_pd(c);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_pd(a + i, _mm512_mul_pd(_mm512_loadu_pd(a + i), constant));
+    for (; i < n; ++i)
+        a[i] = a[i] * c;
+}
+
+__attribute__((target("avx512f"), optimize("fp-contract=off")))
+inline void simd_axpy_avx512(double* a, const double* b, const size_t n, const double c)
+{
+    const __m512d constant = _mm512_set1_pd(c);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_pd(a + i, _mm512_add_pd(_mm512_loadu_pd(a + i), _mm512_mul_pd(constant, _mm512_loadu_pd(b + i))));
+    for (; i < n; ++i)
+        a[i] = a[i] + c * b[i];
+}
+#endif // _SIMD_X86_AVAILABLE
+
+template<>
+struct coefficient_kernels<double>
+{
+    static void add(double* a, const double* b, const size_t n)
+    {
+        Instrumentation::additions(n);
+#ifdef _SIMD_X86_AVAILABLE
+        switch (simd_support())
+        {
+            case simd_avx512: simd_add_avx512(a, b, n); return;
+            case simd_avx2: simd_add_avx2(a, b, n); return;
+            default: break;
+        }
+#endif // _SIMD_X86_AVAILABLE
+        for (size_t i = 0; i < n; ++i)
+            a[i] = a[i] + b[i];
+    }
+
+    static void subtract(double* a, const double* b, const size_t n)
+    {
+        Instrumentation::additions(n);
+#ifdef _SIMD_X86_AVAILABLE
+        switch (simd_support())
+        {
+            case simd_avx512: simd_subtract_avx512(a, b, n); return;
+            case simd_avx2: simd_subtract_avx2(a, b, n); return;
+            default: break;
+        }
+#endif // _SIMD_X86_AVAILABLE
+        for (size_t i = 0; i < n; ++i)
+            a[i] = a[i] - b[i];
+    }
+
+    static void scale(double* a, const size_t n, const double& c)
+    {
+        Instrumentation::multiplications(n);
+#ifdef _SIMD_X86_AVAILABLE
+        switch (simd_support())
+        {
+            case simd_avx512: simd_scale_avx512(a, n, c); return;
+            case simd_avx2: simd_scale_avx2(a, n, c); return;
+            default: break;
+        }
+#endif // _SIMD_X86_AVAILABLE
+        for (size_t i = 0; i < n; ++i)
+            a[i] = a[i] * c;
+    }
+
+    static void axpy(double* a, const double* b, const size_t n, const double& c)
+    {
+        Instrumentation::multiplications(n);
+        Instrumentation::additions(n);
+#ifdef _SIMD_X86_AVAILABLE
+        switch (simd_support())
+        {
+            case simd_avx512: simd_axpy_avx512(a, b, n, c); return;
+            case simd_avx2: simd_axpy_avx2(a, b, n, c); return;
+            default: break;
+        }
+#endif // _SIMD_X86_AVAILABLE
+        for (size_t i = 0; i < n; ++i)
+            a[i] = a[i] + c * b[i];
+    }
+};
+
+/* Residue numbers */
+// The kernels work on reduced numbers modulo mod < 2^63, stored in 64-bit words: the representation of ResidueNum<M>
+// (see Residue.hpp). Addition and subtraction are the same for every representation; multiplication is the
+// Montgomery product of Montgomery64 (with R = 2^64), vectorised for moduli below 2^32, where the products of two
+// numbers fit into a 64-bit lane.
+
+inline bool simd_montgomery_vectorisable(const Montgomery64& field)
+{
+    return field.modulo() < (uint64_t(1) << 32);
+}
+
+// The scalar versions (also the tails of the vector loops)
+inline void simd_residue_add_scalar(uint64_t* a, const uint64_t* b, const size_t n, const uint64_t mod)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        const uint64_t sum = a[i] + b[i];
+        a[i] = sum >= mod ? sum - mod : sum;
+    }
+}
+
+inline void simd_residue_subtract_scalar(uint64_t* a, const uint64_t* b, const size_t n, const uint64_t mod)
+{
+    for (size_t i = 0; i < n; ++i)
+        a[i] = a[i] >= b[i] ? a[i] - b[i] : a[i] + mod - b[i];
+}
+
+inline void simd_montgomery_scale_scalar(uint64_t* a, const size_t n, const uint64_t c, const Montgomery64& field)
+{
+    for (size_t i = 0; i < n; ++i)
+        a[i] = field.multiply(a[i], c);
+}
+
+inline void simd_montgomery_axpy_scalar(uint64_t* a, const uint64_t* b, const size_t n, const uint64_t c, const Montgomery64& field)
+{
+    for (size_t i = 0; i < n; ++i)
+        a[i] = field.add(a[i], field.multiply(c, b[i]));
+}
+
+#ifdef _SIMD_X86_AVAILABLE
+// AVX2 has no unsigned 64-bit comparison: the sign bits are flipped for the signed one.
+__attribute__((target("avx2")))
+inline void simd_residue_add_avx2(uint64_t* a, const uint64_t* b, const size_t n, const uint64_t mod)
+{
+    const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+    const __m256i modulo = _mm256_set1_epi64x(static_cast<long long>(mod));
+    const __m256i modulo_signed = _mm256_xor_si256(modulo, sign);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m256i sum = _mm256_add_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        const __m256i below = _mm256_cmpgt_epi64(modulo_signed, _mm256_xor_si256(sum, sign)); // sum < mod
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i), _mm256_sub_epi64(sum, _mm256_andnot_si256(below, modulo)));
+    }
+
+    simd_residue_add_scalar(a + i, b + i, n - i, mod);
+}
+
+__attribute__((target("avx2")))
+inline void simd_residue_subtract_avx2(uint64_t* a, const uint64_t* b, const size_t n, const uint64_t mod)
+{
+    const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+    const __m256i modulo = _mm256_set1_epi64x(static_cast<long long>(mod));
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        const __m256i borrow = _mm256_cmpgt_epi64(_mm256_xor_si256(right, sign), _mm256_xor_si256(left, sign)); // left < right
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i),
+            _mm256_add_epi64(_mm256_sub_epi64(left, right), _mm256_and_si256(borrow, modulo)));
+    }
+
+    simd_residue_subtract_scalar(a + i, b + i, n - i, mod);
+}
+
+// The Montgomery product of 4 pairs of numbers below mod < 2^32 (see Montgomery64::reduce).
+__attribute__((target("avx2")))
+inline __m256i simd_montgomery_multiply_avx2(const __m256i a, const __m256i b, const __m256i modulo, const __m256i inverse)
+{
+    // t = a * b < 2^64
+    const __m256i t = _mm256_mul_epu32(a, b);
+
+    // m = t * inverse (mod 2^64), from the 32-bit halves
+    const __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(t, _mm256_srli_epi64(inverse, 32)),
+        _mm256_mul_epu32(_mm256_srli_epi64(t, 32), inverse));
+    const __m256i m = _mm256_add_epi64(_mm256_mul_epu32(t, inverse), _mm256_slli_epi64(cross, 32));
+
+    // (t + m * mod) / 2^64: the high word of m * mod, plus the carry of the low words, which add up to 2^64 unless t = 0.
+    const __m256i low = _mm256_mul_epu32(m, modulo);
+    const __m256i high = _mm256_mul_epu32(_mm256_srli_epi64(m, 32), modulo);
+    const __m256i carry = _mm256_add_epi64(_mm256_set1_epi64x(1), _mm256_cmpeq_epi64(t, _mm256_setzero_si256()));
+    const __m256i result = _mm256_add_epi64(_mm256_srli_epi64(_mm256_add_epi64(high, _mm256_srli_epi64(low, 32)), 32), carry);
+
+    // result < 2 mod < 2^33, so the signed comparison is right.
+    return _mm256_sub_epi64(result, _mm256_andnot_si256(_mm256_cmpgt_epi64(modulo, result), modulo));
+}
+
+__attribute__((target("avx2")))
+inline void simd_montgomery_scale_avx2(uint64_t* a, const size_t n, const uint64_t c, const Montgomery64& field)
+{
+    const __m256i modulo = _mm256_set1_epi64x(static_cast<long long>(field.modulo()));
+    const __m256i inverse = _mm256_set1_epi64x(static_cast<long long>(field.reductionFactor()));
+    const __m256i constant = _mm256_set1_epi64x(static_cast<long long>(c));
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i), simd_montgomery_multiply_avx2(left, constant, modulo, inverse));
+    }
+
+    simd_montgomery_scale_scalar(a + i, n - i, c, field);
+}
+
+__attribute__((target("avx2")))
+inline void simd_montgomery_axpy_avx2(uint64_t* a, const uint64_t* b, const size_t n, const uint64_t c, const Montgomery64& field)
+{
+    const __m256i modulo = _mm256_set1_epi64x(static_cast<long long>(field.modulo()));
+    const __m256i inverse = _mm256_set1_epi64x(static_cast<long long>(field.reductionFactor()));
+    const __m256i constant = _mm256_set1_epi64x(static_cast<long long>(c));
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i product = simd_montgomery_multiply_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)), constant, modulo, inverse);
+
+        // The sum is below 2^33: the signed comparison is right.
+        const __m256i sum = _mm256_add_epi64(left, product);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i),
+            _mm256_sub_epi64(sum, _mm256_andnot_si256(_mm256_cmpgt_epi64(modulo, sum), modulo)));
+    }
+
+    simd_montgomery_axpy_scalar(a + i, b + i, n - i, c, field);
+}
+
+__attribute__((target("avx512f")))
+inline void simd_residue_add_avx512(uint64_t* a, const uint64_t* b, const size_t n, const uint64_t mod)
+{
+    const __m512i modulo = _mm512_set1_epi64(static_cast<long long>(mod));
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m512i sum = _mm512_add_epi64(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+        _mm512_storeu_si512(a + i, _mm512_mask_sub_epi64(sum, _mm512_cmpge_epu64_mask(sum, modulo), sum, modulo));
+    }
+
+    simd_residue_add_scalar(a + i, b + i, n - i, mod);
+}
+
+__attribute__((target("avx512f")))
+inline void simd_residue_subtract_avx512(uint64_t* a, const uint64_t* b, const size_t n, const uint64_t mod)
+{
+    const __m512i modulo = _mm512_set1_epi64(static_cast<long long>(mod));
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m512i left = _mm512_loadu_si512(a + i);
+        const __m512i right = _mm512_loadu_si512(b + i);
+        const __m512i difference = _mm512_sub_epi64(left, right);
+        _mm512_storeu_si512(a + i, _mm512_mask_add_epi64(difference, _mm512_cmplt_epu64_mask(left, right), difference, modulo));
+    }
+
+    simd_residue_subtract_scalar(a + i, b + i, n - i, mod);
+}
+
+// The Montgomery product of 8 pairs of numbers below mod < 2^32. (See the AVX2 version.)
+// (The zero-masked forms are the same instructions as the unmasked ones, whose pass-through operand
+// is left undefined in the headers of some compilers, which then warn of it.)
+__attribute__((target("avx512f")))
+inline __m512i simd_montgomery_multiply_avx512(const __m512i a, const __m512i b, const __m512i modulo, const __m512i inverse)
+{
+    const __mmask8 lanes = 0xFF;
+    const __m512i t = _mm512_maskz_mul_epu32(lanes, a, b);
+
+    const __m512i cross = _mm512_add_epi64(_mm512_maskz_mul_epu32(lanes, t, _mm512_maskz_srli_epi64(lanes, inverse, 32)),
+        _mm512_maskz_mul_epu32(lanes, _mm512_maskz_srli_epi64(lanes, t, 32), inverse));
+    const __m512i m = _mm512_add_epi64(_mm512_maskz_mul_epu32(lanes, t, inverse), _mm512_maskz_slli_epi64(lanes, cross, 32));
+
+    const __m512i low = _mm512_maskz_mul_epu32(lanes, m, modulo);
+    const __m512i high = _mm512_maskz_mul_epu32(lanes, _mm512_maskz_srli_epi64(lanes, m, 32), modulo);
+    __m512i result = _mm512_maskz_srli_epi64(lanes, _mm512_add_epi64(high, _mm512_maskz_srli_epi64(lanes, low, 32)), 32);
+    result = _mm512_mask_add_epi64(result, _mm512_test_epi64_mask(t, t), result, _mm512_set1_epi64(1));
+
+    return _mm512_mask_sub_epi64(result, _mm512_cmpge_epu64_mask(result, modulo), result, modulo);
+}
+
+__attribute__((target("avx512f")))
+inline void simd_montgomery_scale_avx512(uint64_t* a, const size_t n, const uint64_t c, const Montgomery64& field)
+{
+    const __m512i modulo = _mm512_set1_epi64(static_cast<long long>(field.modulo()));
+    const __m512i inverse = _mm512_set1_epi64(static_cast<long long>(field.reductionFactor()));
+    const __m512i constant = _mm512_set1_epi64(static_cast<long long>(c));
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_si512(a + i, simd_montgomery_multiply_avx512(_mm512_loadu_si512(a + i), constant, modulo, inverse));
+
+    simd_montgomery_scale_scalar(a + i, n - i, c, field);
+}
+
+__attribute__((target("avx512f")))
+inline void simd_montgomery_axpy_avx512(uint64_t* a, const uint64_t* b, const size_t n, const uint64_t c, const Montgomery64& field)
+{
+    const __m512i modulo = _mm512_set1_epi64(static_cast<long long>(field.modulo()));
+    const __m512i inverse = _mm512_set1_epi64(static_cast<long long>(field.reductionFactor()));
+    const __m512i constant = _mm512_set1_epi64(static_cast<long long>(c));
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m512i left = _mm512_loadu_si512(a + i);
+        const __m512i product = simd_montgomery_multiply_avx512(_mm512_loadu_si512(b + i), constant, modulo, inverse);
+        const __m512i sum = _mm512_add_epi64(left, product);
+        _mm512_storeu_si512(a + i, _mm512_mask_sub_epi64(sum, _mm512_cmpge_epu64_mask(sum, modulo), sum, modulo));
+    }
+
+    simd_montgomery_axpy_scalar(a + i, b + i, n - i, c, field);
+}
+#endif // _SIMD_X86_AVAILABLE
+
+// a = a + b (mod mod)
+inline void simd_residue_add(uint64_t* a, const uint64_t* b, const size_t n, const uint64_t mod)
+{
+#ifdef _SIMD_X86_AVAILABLE
+    switch (simd_support())
+    {
+        case simd_avx512: simd_residue_add_avx512(a, b, n, mod); return;
+        case simd_avx2: simd_residue_add_avx2(a, b, n, mod); return;
+        default: break;
+    }
+#endif // _SIMD_X86_AVAILABLE
+    simd_residue_add_scalar(a, b, n, mod);
+}
+
+// a = a - b (mod mod)
+inline void simd_residue_subtract(uint64_t* a, const uint64_t* b, const size_t n, const uint64_t mod)
+{
+#ifdef _SIMD_X86_AVAILABLE
+    switch (simd_support())
+    {
+        case simd_avx512: simd_residue_subtract_avx512(a, b, n, mod); return;
+        case simd_avx2: simd_residue_subtract_avx2(a, b, n, mod); return;
+        default: break;
+    }
+#endif // _SIMD_X86_AVAILABLE
+    simd_residue_subtract_scalar(a, b, n, mod);
+}
+
+// a = a * c, in Montgomery form
+inline void simd_montgomery_scale(uint64_t* a, const size_t n, const uint64_t c, const Montgomery64& field)
+{
+#ifdef _SIMD_X86_AVAILABLE
+    if (simd_montgomery_vectorisable(field))
+    {
+        switch (simd_support())
+        {
+            case simd_avx512: simd_montgomery_scale_avx512(a, n, c, field); return;
+            case simd_avx2: simd_montgomery_scale_avx2(a, n, c, field); return;
+            default: break;
+        }
+    }
+#endif // _SIMD_X86_AVAILABLE
+    simd_montgomery_scale_scalar(a, n, c, field);
+}
+
+// a = a + c * b, in Montgomery form
+inline void simd_montgomery_axpy(uint64_t* a, const uint64_t* b, const size_t n, const uint64_t c, const Montgomery64& field)
+{
+#ifdef _SIMD_X86_AVAILABLE
+    if (simd_montgomery_vectorisable(field))
+    {
+        switch (simd_support())
+        {
+            case simd_avx512: simd_montgomery_axpy_avx512(a, b, n, c, field); return;
+            case simd_avx2: simd_montgomery_axpy_avx2(a, b, n, c, field); return;
+            default: break;
+        }
+    }
+#endif // _SIMD_X86_AVAILABLE
+    simd_montgomery_axpy_scalar(a, b, n, c, field);
+}
+
+#endif // _SIMD_KERNELS_H
@@ -0,0 +1,404 @@
+#ifndef _SUBPRODUCT_TREE_H
+#define _SUBPRODUCT_TREE_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include "add_mult_identity.hpp"
+#include "inverse_wrapper.hpp"
+#include "PolynomialThresholds.hpp"
+#include "PolynomialMultiply.hpp"
+#include "PolynomialDivision.hpp"
+#include "SimdKernels.hpp"
+#include "Polynomial.hpp"
+
+// The subproduct tree of a set of points u0, ..., u(n-1): a binary tree whose leaves are the polynomials (x - ui),
+// and every other node is the product of its children, so the root is the product of every (x - ui).
+//
+// A polynomial p takes the same value at ui as p mod (x - ui), and the remainders of p by a node are the
+// remainders of (p mod parent) by the node. So p is evaluated at every point by taking it modulo the root, and then
+// taking each remainder modulo the children, down to the leaves: with fast multiplication and division that is
+// O(M(n) log n) instead of the n Horner evaluations of O(n) each.
+//
+// The tree only depends on the points, so it is built once for every polynomial evaluated at the same points.
+// The nodes are kept as coefficient buffers (the ith element is the coefficient of x^i). They are all monic,
+// so dividing by them needs no inverse; for the large ones the reciprocals for the Newton division are kept too.
+// Below polynomial_thresholds::multipoint_evaluation points, the leaves evaluate their remainder by Horner's rule.
+//
+// The same tree interpolates: the polynomial of degree < n taking the values vi at the points ui is
+//     p = sum of wi * M / (x - ui),  where M is the root and wi = vi / M'(ui)
+// (Lagrange's formula, as M / (x - ui) is 0 at every other point and M'(ui) at ui). The values of M' are
+// a multipoint evaluation, and the sum is built up the tree: the sum of a node is
+// (sum of the left child) * (right child) + (sum of the right child) * (left child).
+template<typename T>
+class SubproductTree
+{
+    public:
+        // Build the tree of the given points
+        explicit SubproductTree(const std::vector<T>& points);
+
+        // Get the points
+        const std::vector<T>& points() const { return this->m_points; }
+        size_t size() const { return this->m_points.size(); }
+
+        // The product of (x - u) for every point u
+        Polynomial<T> root() const;
+
+        // The values of the polynomial at every point (in the order of the points)
+        template<typename Storage>
+        std::vector<T> evaluate(const Polynomial<T, Storage>& poly) const;
+
+        // The polynomial of degree < n taking the given value at every point (in the order of the points).
+        // T has to be a field. Throws std::invalid_argument if the number of values is not the number of points,
+        // or the points are not distinct.
+        // (With floating-point T, the coefficients lose about a digit for every few points, however they are computed:
+        // the monomial basis is ill-conditioned.)
+        template<typename Storage = DenseStorage<T> >
+        Polynomial<T, Storage> interpolate(const std::vector<T>& values) const;
+
+    private:
+        std::vector<T> m_points;
+
+        // Points per leaf, and the nodes level by level from the leaves up.
+        // Node j of level k is the product of (x - u) for the points from j * leaf * 2^k on, and has
+        // the nodes 2j and 2j + 1 of level k - 1 as its children (the second one is missing at the end of odd levels).
+        size_t m_leaf;
+        std::vector<std::vector<std::vector<T> > > m_levels;
+
+        // rev(node)^-1 modulo x^k, where k is the most that a quotient by the node can have in the descent
+        // (empty where the node is divided by the long division).
+        std::vector<std::vector<std::vector<T> > > m_reciprocals;
+
+        // The values at every point of the polynomial of the given coefficients
+        std::vector<T> evaluateCoefficients(std::vector<T> coefficients) const;
+
+        // Reduce the remainder by the node and its subtree, and write the values at its points.
+        void descend(const size_t level, const size_t index, std::vector<T> remainder, T* values) const;
+
+        // remainder = remainder mod node (of the given level)
+        void reduce(const size_t level, const size_t index, std::vector<T>& remainder) const;
+
+        // Horner's rule over a coefficient buffer
+        static T horner(const std::vector<T>& coefficients, const T& point);
+};
+
+template<typename T>
+SubproductTree<T>::SubproductTree(const std::vector<T>& points)
+    : m_points(points), m_leaf(std::max<size_t>(1, polynomial_thresholds::multipoint_evaluation))
+{
+    if (points.empty())
+        return;
+
+    // The leaves are multiplied together by one (x - u) at a time.
+    std::vector<std::vector<T> > leaves((points.size() + this->m_leaf - 1) / this->m_leaf);
+    for (size_t j = 0; j < leaves.size(); ++j)
+    {
+        std::vector<T>& leaf = leaves[j];
+        leaf.assign(1, id_multiplicative<T>::value);
+
+        const size_t end = std::min(points.size(), (j + 1) * this->m_leaf);
+        for (size_t i = j * this->m_leaf; i < end; ++i)
+        {
+            // leaf = leaf * (x - u) = x * leaf - u * leaf
+            leaf.push_back(id_multiplicative<T>::value);
+            for (size_t p = leaf.size() - 2; p > 0; --p)
+                leaf[p] = leaf[p - 1] - points[i] * leaf[p];
+            leaf[0] = id_additive<T>::value - points[i] * leaf[0];
+        }
+    }
+    this->m_levels.push_back(std::move(leaves));
+
+    // Every further level holds the products of pairs.
+    while (this->m_levels.back().size() > 1)
+    {
+        const std::vector<std::vector<T> >& below = this->m_levels.back();
+        std::vector<std::vector<T> > level((below.size() + 1) / 2);
+        for (size_t j = 0; j < level.size(); ++j)
+        {
+            if (2 * j + 1 == below.size())
+            {
+                level[j] = below[2 * j];
+                continue;
+            }
+
+            const std::vector<T>& left = below[2 * j];
+            const std::vector<T>& right = below[2 * j + 1];
+            level[j].resize(left.size() + right.size() - 1);
+            polynomial_multiplier<T>::multiply(left.data(), left.size(), right.data(), right.size(), level[j].data());
+        }
+
+        this->m_levels.push_back(std::move(level));
+    }
+
+    // The quotients by a child are at most as long as the degree of its parent minus its own.
+    this->m_reciprocals.resize(this->m_levels.size());
+    for (size_t k = 0; k + 1 < this->m_levels.size(); ++k)
+    {
+        const std::vector<std::vector<T> >& level = this->m_levels[k];
+        this->m_reciprocals[k].resize(level.size());
+        for (size_t j = 0; j < level.size(); ++j)
+        {
+            const std::vector<T>& node = level[j];
+            const size_t quotient_size = this->m_levels[k + 1][j / 2].size() - node.size();
+            if (quotient_size == 0 || !use_newton_division<T>(quotient_size, node.size()))
+                continue;
+
+            std::vector<T> reversed(node.rbegin(), node.rend());
+            newton_reciprocal(reversed.data(), reversed.size(), quotient_size, this->m_reciprocals[k][j]);
+        }
+    }
+}
+
+template<typename T>
+Polynomial<T> SubproductTree<T>::root() const
+{
+    if (this->m_levels.empty())
+        return Polynomial<T>(id_multiplicative<T>::value);
+
+    const std::vector<T>& root = this->m_levels.back().front();
+    return Polynomial<T>(root.begin(), root.end());
+}
+
+template<typename T>
+template<typename Storage>
+std::vector<T> SubproductTree<T>::evaluate(const Polynomial<T, Storage>& poly) const
+{
+    std::vector<T> coefficients;
+    if (!poly.isNull())
+    {
+        coefficients.resize(poly.degree() + 1, id_additive<T>::value);
+        for (const auto& member : poly.members())
+            coefficients[member.first] = member.second;
+    }
+
+    return this->evaluateCoefficients(std::move(coefficients));
+}
+
+template<typename T>
+std::vector<T> SubproductTree<T>::evaluateCoefficients(std::vector<T> coefficients) const
+{
+    std::vector<T> values(this->m_points.size(), id_additive<T>::value);
+    if (this->m_points.empty() || coefficients.empty())
+        return values;
+
+    // The root can be divided by the polynomial's own degree, so that is the only division without a kept reciprocal.
+    const std::vector<T>& root = this->m_levels.back().front();
+    if (coefficients.size() >= root.size())
+    {
+        std::vector<T> quotient, remainder;
+        if (use_newton_division<T>(coefficients.size() - root.size() + 1, root.size()))
+        {
+            newton_divide(coefficients.data(), coefficients.size(), root.data(), root.size(), quotient, remainder);
+            coefficients.swap(remainder);
+        }
+        else
+        {
+            this->reduce(this->m_levels.size() - 1, 0, coefficients);
+        }
+    }
+
+    this->descend(this->m_levels.size() - 1, 0, std::move(coefficients), values.data());
+    return values;
+}
+
+template<typename T>
+template<typename Storage>
+Polynomial<T, Storage> SubproductTree<T>::interpolate(const std::vector<T>& values) const
+{
+    const size_t n = this->m_points.size();
+    if (values.size() != n)
+        throw std::invalid_argument("interpolation needs exactly one value for every point");
+    if (n == 0)
+        return Polynomial<T, Storage>();
+
+    // M' at every point. (M'(ui) is the product of (ui - uj) for every other point, so it is 0 for a repeated point.)
+    const std::vector<T>& root = this->m_levels.back().front();
+    std::vector<T> derivative(root.size() - 1);
+    for (size_t i = 1; i < root.size(); ++i)
+        derivative[i - 1] = repeated_sum(root[i], i);
+
+    std::vector<T> weights = this->evaluateCoefficients(std::move(derivative));
+    for (const T& weight : weights)
+        if (weight == id_additive<T>::value)
+            throw std::invalid_argument("interpolation points must be distinct");
+
+    // wi = vi / M'(ui), with a single inversion if T has a known inverse.
+    if constexpr (multiplicative_inverse<T>::known)
+    {
+        batch_inverse(weights.data(), n, weights.data());
+        for (size_t i = 0; i < n; ++i)
+            weights[i] = values[i] * weights[i];
+    }
+    else
+    {
+        for (size_t i = 0; i < n; ++i)
+            weights[i] = values[i] / weights[i];
+    }
+
+    // The sums of the leaves, one (leaf / (x - ui)) at a time. O(leaf^2)
+    std::vector<std::vector<T> > sums(this->m_levels[0].size());
+    std::vector<T> quotient;
+    for (size_t j = 0; j < sums.size(); ++j)
+    {
+        const std::vector<T>& leaf = this->m_levels[0][j];
+        const size_t degree = leaf.size() - 1;
+        sums[j].assign(degree, id_additive<T>::value);
+        quotient.resize(degree);
+
+        for (size_t i = j * this->m_leaf; i < std::min(n, (j + 1) * this->m_leaf); ++i)
+        {
+            // Synthetic division: leaf = (x - ui) * quotient, as ui is a root of the leaf.
+            quotient[degree - 1] = leaf[degree];
+            for (size_t p = degree - 1; p > 0; --p)
+                quotient[p - 1] = leaf[p] + this->m_points[i] * quotient[p];
+
+            coefficient_kernels<T>::axpy(sums[j].data(), quotient.data(), degree, weights[i]);
+        }
+    }
+
+    // The sums of the nodes above
+    for (size_t k = 1; k < this->m_levels.size(); ++k)
+    {
+        const std::vector<std::vector<T> >& below = this->m_levels[k - 1];
+        std::vector<std::vector<T> > level_sums((below.size() + 1) / 2);
+        for (size_t j = 0; j < level_sums.size(); ++j)
+        {
+            if (2 * j + 1 == below.size())
+            {
+                level_sums[j].swap(sums[2 * j]);
+                continue;
+            }
+
+            const std::vector<T>& left = below[2 * j];
+            const std::vector<T>& right = below[2 * j + 1];
+            const std::vector<T>& left_sum = sums[2 * j];
+            const std::vector<T>& right_sum = sums[2 * j + 1];
+
+            // left_sum * right + right_sum * left, both of degree < deg(left) + deg(right)
+            std::vector<T>& sum = level_sums[j];
+            sum.resize(left_sum.size() + right.size() - 1);
+            polynomial_multiplier<T>::multiply(left_sum.data(), left_sum.size(), right.data(), right.size(), sum.data());
+
+            std::vector<T> product(right_sum.size() + left.size() - 1);
+            polynomial_multiplier<T>::multiply(right_sum.data(), right_sum.size(), left.data(), left.size(), product.data());
+            coefficient_kernels<T>::add(sum.data(), product.data(), product.size());
+        }
+
+        sums.swap(level_sums);
+    }
+
+    const std::vector<T>& result = sums.front();
+    return Polynomial<T, Storage>(result.begin(), result.end());
+}
+
+template<typename T>
+void SubproductTree<T>::descend(const size_t level, const size_t index, std::vector<T> remainder, T* values) const
+{
+    if (level == 0)
+    {
+        const size_t begin = index * this->m_leaf;
+        const size_t end = std::min(this->m_points.size(), begin + this->m_leaf);
+        for (size_t i = begin; i < end; ++i)
+            values[i] = horner(remainder, this->m_points[i]);
+        return;
+    }
+
+    const size_t left = 2 * index;
+    const size_t right = left + 1;
+    if (right < this->m_levels[level - 1].size())
+    {
+        std::vector<T> right_remainder = remainder;
+        this->reduce(level - 1, right, right_remainder);
+        this->descend(level - 1, right, std::move(right_remainder), values);
+    }
+
+    this->reduce(level - 1, left, remainder);
+    this->descend(level - 1, left, std::move(remainder), values);
+}
+
+template<typename T>
+void SubproductTree<T>::reduce(const size_t level, const size_t index, std::vector<T>& remainder) const
+{
+    const std::vector<T>& node = this->m_levels[level][index];
+    const size_t degree = node.size() - 1;
+    if (remainder.size() <= degree)
+        return;
+
+    const size_t quotient_size = remainder.size() - degree;
+    const std::vector<T>* reciprocal = (level < this->m_reciprocals.size() && index < this->m_reciprocals[level].size()) ?
+        &this->m_reciprocals[level][index] : nullptr;
+
+    if (reciprocal != nullptr && reciprocal->size() >= quotient_size)
+    {
+        // rev(q) = rev(remainder) * rev(node)^-1 (mod x^quotient_size), see PolynomialDivision.hpp.
+        std::vector<T> reversed(quotient_size);
+        for (size_t i = 0; i < quotient_size; ++i)
+            reversed[i] = remainder[remainder.size() - 1 - i];
+
+        std::vector<T> product(2 * quotient_size - 1);
+        polynomial_multiplier<T>::multiply(reversed.data(), quotient_size, reciprocal->data(), quotient_size, product.data());
+
+        std::vector<T> quotient(quotient_size);
+        for (size_t i = 0; i < quotient_size; ++i)
+            quotient[i] = product[quotient_size - 1 - i];
+
+        // remainder - q * node only has members below the degree of the node.
+        product.resize(quotient_size + degree);
+        polynomial_multiplier<T>::multiply(quotient.data(), quotient_size, node.data(), node.size(), product.data());
+
+        remainder.resize(degree);
+        coefficient_kernels<T>::subtract(remainder.data(), product.data(), degree);
+    }
+    else
+    {
+        // The long division by a monic polynomial: every member of the quotient is the top of the remainder.
+        for (size_t q = quotient_size; q-- > 0; )
+        {
+            T* window = remainder.data() + q;
+            if (window[degree] == id_additive<T>::value) continue;
+
+            coefficient_kernels<T>::axpy(window, node.data(), degree, id_additive<T>::value - window[degree]);
+        }
+
+        remainder.resize(degree);
+    }
+}
+
+template<typename T>
+T SubproductTree<T>::horner(const std::vector<T>& coefficients, const T& point)
+{
+    T result = id_additive<T>::value;
+    for (size_t i = coefficients.size(); i-- > 0; )
+        result = result * point + coefficients[i];
+
+    return result;
+}
+
+// The values of the polynomial at every point. (Build a SubproductTree to evaluate many polynomials at the same points.)
+template<typename T, typename Storage>
+std::vector<T> multipoint_evaluate(const Polynomial<T, Storage>& poly, const std::vector<T>& points)
+{
+    // A few points are not worth a tree.
+    if (points.size() <= polynomial_thresholds::multipoint_evaluation)
+    {
+        std::vector<T> values;
+        values.reserve(points.size());
+        for (const T& point : points)
+            values.push_back(poly.at(point));
+
+        return values;
+    }
+
+    return SubproductTree<T>(points).evaluate(poly);
+}
+
+// The polynomial of degree < n taking the value values[i] at points[i]. (See SubproductTree::interpolate.)
+template<typename T, typename Storage = DenseStorage<T> >
+Polynomial<T, Storage> interpolate(const std::vector<T>& points, const std::vector<T>& values)
+{
+    return SubproductTree<T>(points).template interpolate<Storage>(values);
+}
+
+#endif // _SUBPRODUCT_TREE_H
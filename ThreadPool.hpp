@@ -0,0 +1,190 @@
+#ifndef _THREAD_POOL_H
+#define _THREAD_POOL_H
+
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads running batches of independent tasks, with work stealing.
+//
+// The tasks of a batch are dealt out to the queues of the workers in the given order. Every worker takes
+// the tasks of its own queue from the front; once it runs out, it steals from the back of the others'.
+// So if the order is by descending cost, every worker starts with its most expensive tasks,
+// and the cheapest ones are left at the end to even out the finishing times.
+class ThreadPool
+{
+    public:
+        // A pool of the given number of workers (0: one for every hardware thread)
+        explicit ThreadPool(size_t workers = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator = (const ThreadPool&) = delete;
+
+        size_t workers() const { return this->m_threads.size(); }
+
+        // Run task(i) for every index i of order (the first ones are started first), and wait until every one is done.
+        // If tasks throw, the rest still run, and the first exception is rethrown here.
+        // (Batches of one pool run one after the other. Don't start a batch of the same pool from a task.)
+        void run(const std::vector<size_t>& order, std::function<void(size_t)> task);
+
+    private:
+        struct WorkQueue
+        {
+            std::mutex mutex;
+            std::deque<size_t> tasks;
+        };
+
+        std::vector<WorkQueue> m_queues;
+        std::vector<std::thread> m_threads;
+
+        // The current batch. (Set under m_mutex, while no worker is active.)
+        std::function<void(size_t)> m_task;
+        std::atomic<size_t> m_remaining;
+        std::exception_ptr m_error;
+
+        std::mutex m_runMutex;           // One batch at a time
+        std::mutex m_mutex;              // Guards the state below
+        std::condition_variable m_wake;  // Workers wait for a batch
+        std::condition_variable m_done;  // run() waits for the workers
+        size_t m_generation;             // Incremented for every batch
+        size_t m_active;                 // Number of workers working on the batch
+        bool m_stopping;
+
+        void work(const size_t worker);
+
+        // The next task of the worker: from its own queue, or stolen from another one.
+        bool next(const size_t worker, size_t& index);
+};
+
+inline ThreadPool::ThreadPool(size_t workers)
+    : m_remaining(0), m_generation(0), m_active(0), m_stopping(false)
+{
+    if (workers == 0)
+        workers = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+    this->m_queues = std::vector<WorkQueue>(workers);
+    this->m_threads.reserve(workers);
+    for (size_t i = 0; i < workers; ++i)
+        this->m_threads.emplace_back(&ThreadPool::work, this, i);
+}
+
+inline ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->m_mutex);
+        this->m_stopping = true;
+    }
+    this->m_wake.notify_all();
+
+    for (std::thread& thread : this->m_threads)
+        thread.join();
+}
+
+inline void ThreadPool::run(const std::vector<size_t>& order, std::function<void(size_t)> task)
+{
+    if (order.empty())
+        return;
+
+    std::lock_guard<std::mutex> run_lock(this->m_runMutex);
+    std::unique_lock<std::mutex> lock(this->m_mutex);
+
+    // Workers late for the previous batch must not pick up the tasks of this one with the old task.
+    this->m_done.wait(lock, [this]() { return this->m_active == 0; });
+
+    this->m_task = std::move(task);
+    this->m_error = nullptr;
+    this->m_remaining = order.size();
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        WorkQueue& queue = this->m_queues[i % this->m_queues.size()];
+        std::lock_guard<std::mutex> queue_lock(queue.mutex);
+        queue.tasks.push_back(order[i]);
+    }
+
+    ++this->m_generation;
+    this->m_wake.notify_all();
+
+    this->m_done.wait(lock, [this]() { return this->m_remaining == 0 && this->m_active == 0; });
+    this->m_task = nullptr;
+
+    if (this->m_error)
+        std::rethrow_exception(this->m_error);
+}
+
+inline void ThreadPool::work(const size_t worker)
+{
+    size_t seen = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(this->m_mutex);
+            this->m_wake.wait(lock, [this, &seen]() { return this->m_stopping || this->m_generation != seen; });
+            if (this->m_stopping)
+                return;
+
+            seen = this->m_generation;
+            ++this->m_active;
+        }
+
+        size_t index;
+        while (this->next(worker, index))
+        {
+            try
+            {
+                this->m_task(index);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(this->m_mutex);
+                if (!this->m_error)
+                    this->m_error = std::current_exception();
+            }
+
+            --this->m_remaining;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(this->m_mutex);
+            --this->m_active;
+        }
+        this->m_done.notify_all();
+    }
+}
+
+inline bool ThreadPool::next(const size_t worker, size_t& index)
+{
+    {
+        WorkQueue& own = this->m_queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty())
+        {
+            index = own.tasks.front();
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+
+    for (size_t i = 1; i < this->m_queues.size(); ++i)
+    {
+        WorkQueue& victim = this->m_queues[(worker + i) % this->m_queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty())
+        {
+            index = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#endif // _THREAD_POOL_H
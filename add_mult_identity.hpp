@@ -36,7 +36,7 @@ struct id_multiplicative
 template<typename _T>
 struct id_multiplicative_integral
 {
-	static const _T value = 1;
+	static constexpr _T value = 1;
 };
 
 
@@ -109,7 +109,7 @@ struct id_additive
 template<typename _T>
 struct id_additive_integral
 {
-    static const _T value = 0;
+    static constexpr _T value = 0;
 };
 
 template<> struct id_additive_exists<char> : id_additive_known{};
@@ -0,0 +1,479 @@
+// Benchmarks of the polynomial arithmetic and the Euclidean algorithms.
+//
+// Build and run (from the directory of the sources):
+//     g++ -std=c++17 -O2 -march=native -pthread benchmark.cpp -o benchmark
+//     ./benchmark [--filter text] [--min-time ms] [--json results.json] [--compare baseline.json] [--threshold 0.1]
+//
+// Every operation is measured on random operands, swept over the degree, the density (the ratio of the non-zero
+// coefficients; sparse operands are kept in SparseStorage) and the coefficient type. A measurement repeats
+// the operation until it ran for at least the minimal time, and reports the time and the heap allocations
+// of one operation, and the coefficients of the input processed per second.
+//
+// --json writes the results as a JSON array (one result per line), which can be given back to --compare
+// later: every result is then compared with the one of the same name in the baseline, and the ones slower
+// by more than the threshold (10% by default) are reported as regressions (the exit code is 1 if there is any).
+//
+// The batch results (BatchEuclidean.hpp) are checked against the ones of extended_euclidean before they are
+// measured; the exit code is 1 as well if any is wrong.
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Polynomial.hpp"
+#include "PolynomialText.hpp"
+#include "Residue.hpp"
+#include "HalfGCD.hpp"
+#include "BatchEuclidean.hpp"
+
+// Count the heap allocations of the whole program.
+// (GCC takes the free() of the replaced operator delete for a mismatch with the new expressions it is inlined into.)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+static std::atomic<size_t> g_allocations(0);
+static std::atomic<size_t> g_allocated_bytes(0);
+
+void* operator new(size_t bytes)
+{
+    ++g_allocations;
+    g_allocated_bytes += bytes;
+    if (void* pointer = std::malloc(bytes == 0 ? 1 : bytes))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { std::free(pointer); }
+
+// The results of the operations are summed here, so that they are not optimised away.
+static volatile size_t g_sink = 0;
+
+typedef ResidueNum<2> Residue2;
+typedef ResidueNum<998244353> ResidueP;
+
+// Random coefficients of a type, and the point the polynomials are evaluated at.
+template<typename T>
+struct benchmark_coefficient;
+
+template<>
+struct benchmark_coefficient<long>
+{
+    static const char* name() { return "long"; }
+    static long random(std::mt19937_64& rng) { return static_cast<long>(rng() % 19) - 9; }
+    static long point() { return 1; } // (Any other point overflows at high degrees.)
+    static const bool exact_division = false;
+};
+
+template<>
+struct benchmark_coefficient<double>
+{
+    static const char* name() { return "double"; }
+    static double random(std::mt19937_64& rng) { return std::uniform_real_distribution<double>(-1, 1)(rng); }
+    static double point() { return 0.999; }
+    static const bool exact_division = true;
+};
+
+template<long M>
+struct benchmark_coefficient<ResidueNum<M> >
+{
+    static const char* name() { return M == 2 ? "residue2" : "residue_p"; }
+    static ResidueNum<M> random(std::mt19937_64& rng) { return ResidueNum<M>(static_cast<long>(rng() % M)); }
+    static ResidueNum<M> point() { return ResidueNum<M>(3 % M); }
+    static const bool exact_division = true;
+};
+
+struct BenchmarkResult
+{
+    std::string name;
+    size_t iterations;
+    double ns_per_op;
+    double items_per_second;
+    double allocations_per_op;
+    double bytes_per_op;
+};
+
+struct BenchmarkOptions
+{
+    std::string filter;
+    double min_time = 0.05; // seconds
+    std::string json;
+    std::string compare;
+    double threshold = 0.1;
+};
+
+// Run op until it took at least the minimal time. (items: the number of items processed by one op)
+template<typename F>
+BenchmarkResult measure(const std::string& name, const double items, const BenchmarkOptions& options, F op)
+{
+    typedef std::chrono::steady_clock clock;
+
+    op(); // Warm up (and fill the caches of the engines, like the NTT roots)
+
+    size_t iterations = 1;
+    for (;;)
+    {
+        const size_t allocations = g_allocations, bytes = g_allocated_bytes;
+        const clock::time_point start = clock::now();
+        for (size_t i = 0; i < iterations; ++i)
+            op();
+        const double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+
+        if (elapsed >= options.min_time || iterations >= (size_t(1) << 30))
+        {
+            BenchmarkResult result;
+            result.name = name;
+            result.iterations = iterations;
+            result.ns_per_op = elapsed * 1e9 / iterations;
+            result.items_per_second = items * iterations / elapsed;
+            result.allocations_per_op = static_cast<double>(g_allocations - allocations) / iterations;
+            result.bytes_per_op = static_cast<double>(g_allocated_bytes - bytes) / iterations;
+            return result;
+        }
+
+        // Aim at the minimal time (with a margin), but at least double the count.
+        const double target = elapsed > 0 ? options.min_time * 1.2 / elapsed * iterations : 2.0 * iterations;
+        iterations = std::max(2 * iterations, static_cast<size_t>(target));
+    }
+}
+
+// A random polynomial of the given degree, where every coefficient is non-zero with the probability density.
+template<typename T, typename Storage>
+Polynomial<T, Storage> random_polynomial(std::mt19937_64& rng, const size_t degree, const double density)
+{
+    Polynomial<T, Storage> poly;
+    {
+        typename Polynomial<T, Storage>::BatchEdit batch(poly);
+        batch.reserve(degree);
+        std::bernoulli_distribution member(density);
+        for (size_t i = 0; i < degree; ++i)
+            if (member(rng))
+                batch.setMember(i, benchmark_coefficient<T>::random(rng));
+
+        T lc;
+        do lc = benchmark_coefficient<T>::random(rng); while (lc == id_additive<T>::value);
+        batch.setMember(degree, lc);
+    }
+
+    return poly;
+}
+
+class BenchmarkRunner
+{
+    public:
+        explicit BenchmarkRunner(const BenchmarkOptions& options) : m_options(options) {}
+
+        template<typename F>
+        void run(const std::string& name, const double items, F op)
+        {
+            if (!this->m_options.filter.empty() && name.find(this->m_options.filter) == std::string::npos)
+                return;
+
+            const BenchmarkResult result = measure(name, items, this->m_options, op);
+            this->m_results.push_back(result);
+
+            std::printf("%-44s %14.0f ns/op %14.4g items/s %10.1f allocs/op\n",
+                result.name.c_str(), result.ns_per_op, result.items_per_second, result.allocations_per_op);
+            std::fflush(stdout);
+        }
+
+        const std::vector<BenchmarkResult>& results() const { return this->m_results; }
+
+    private:
+        const BenchmarkOptions& m_options;
+        std::vector<BenchmarkResult> m_results;
+};
+
+// The polynomial operations on the coefficient type T, with the given storage
+template<typename T, typename Storage>
+void benchmark_polynomials(BenchmarkRunner& runner, const double density, const std::vector<size_t>& degrees)
+{
+    typedef Polynomial<T, Storage> P;
+    std::mt19937_64 rng(12345);
+
+    for (const size_t degree : degrees)
+    {
+        std::ostringstream suffix;
+        suffix << "/" << benchmark_coefficient<T>::name() << "/" << (Storage::contiguous ? "dense" : "sparse")
+            << "/d" << density << "/" << degree;
+
+        const P a = random_polynomial<T, Storage>(rng, degree, density);
+        const P b = random_polynomial<T, Storage>(rng, degree, density);
+        const P half = random_polynomial<T, Storage>(rng, degree / 2, density);
+        const P below = random_polynomial<T, Storage>(rng, degree - 1, density);
+        const double items = static_cast<double>(degree + 1);
+
+        runner.run("multiply" + suffix.str(), items, [&a, &b]() { g_sink = g_sink + (a * b).degree(); });
+        runner.run("at" + suffix.str(), items, [&a]() { g_sink = g_sink + (a.at(benchmark_coefficient<T>::point()) == id_additive<T>::value); });
+        runner.run("derive" + suffix.str(), items, [&a]() { g_sink = g_sink + a.derive().degree(); });
+
+        // (The integer remainder sequences overflow: there are only the operations without division for them.)
+        if constexpr (benchmark_coefficient<T>::exact_division)
+        {
+            runner.run("divide" + suffix.str(), items, [&a, &half]()
+            {
+                P q, r;
+                divmod(a, half, q, r);
+                g_sink = g_sink + q.degree() + r.degree();
+            });
+
+            runner.run("euclidean" + suffix.str(), items, [&a, &below]() { g_sink = g_sink + euclidean(a, below).degree(); });
+            runner.run("extended_euclidean" + suffix.str(), items, [&a, &below]() { g_sink = g_sink + extended_euclidean(a, below).x.degree(); });
+        }
+    }
+}
+
+// The polynomial operations on T, for every density
+template<typename T>
+void benchmark_type(BenchmarkRunner& runner)
+{
+    const std::vector<size_t> degrees = { 16, 256, 2048 };
+
+    benchmark_polynomials<T, DenseStorage<T> >(runner, 1.0, degrees);
+    benchmark_polynomials<T, DenseStorage<T> >(runner, 0.1, degrees);
+    // (The sparse remainder sequences fill up: only the smaller degrees are worth waiting for.)
+    benchmark_polynomials<T, SparseStorage<T> >(runner, 0.1, { 16, 256 });
+}
+
+// The Euclidean algorithms of many pairs on a ThreadPool (see BatchEuclidean.hpp).
+// The results are checked first against the ones of extended_euclidean: false if any is wrong.
+template<typename T>
+bool benchmark_batch(BenchmarkRunner& runner)
+{
+    typedef Polynomial<T> P;
+    const size_t pairs_count = 256;
+    const size_t degree = 64;
+    const std::string suffix = std::string("/") + benchmark_coefficient<T>::name() + "/" + std::to_string(pairs_count)
+        + "x" + std::to_string(degree);
+
+    // Coprime pairs (the most common ones), and a pair with a null polynomial
+    std::mt19937_64 rng(13579);
+    std::vector<std::pair<P, P> > pairs;
+    while (pairs.size() < pairs_count)
+    {
+        P a = random_polynomial<T, DenseStorage<T> >(rng, degree, 1.0);
+        P b = random_polynomial<T, DenseStorage<T> >(rng, degree - 1, 1.0);
+        if (extended_euclidean(a, b).gcd.degree() == 0)
+            pairs.emplace_back(std::move(a), std::move(b));
+    }
+    pairs.emplace_back(pairs[0].first, P());
+
+    ThreadPool pool;
+    const std::vector<P> gcds = batch_euclidean(pairs, pool);
+    const std::vector<EEuclideanResult<P> > results = batch_extended_euclidean(pairs, pool);
+
+    bool correct = true;
+    for (size_t i = 0; i < pairs.size(); ++i)
+    {
+        const EEuclideanResult<P> expected = extended_euclidean(pairs[i].first, pairs[i].second);
+        const EEuclideanResult<P>& result = results[i];
+
+        // (The GCDs of euclidean are unique up to a unit: a constant for the coprime pairs.)
+        const bool gcd_correct = pairs[i].second.isNull() ? gcds[i] == pairs[i].first
+            : !gcds[i].isNull() && gcds[i].degree() == expected.gcd.degree();
+        const bool extended_correct = result.gcd == expected.gcd && result.x == expected.x && result.y == expected.y
+            && result.x * pairs[i].first + result.y * pairs[i].second == result.gcd;
+        if (!gcd_correct || !extended_correct)
+        {
+            std::fprintf(stderr, "batch%s: the result of the pair %zu is wrong\n", suffix.c_str(), i);
+            correct = false;
+        }
+    }
+
+    runner.run("batch_euclidean" + suffix, static_cast<double>(pairs.size()), [&pairs, &pool]()
+    {
+        g_sink = g_sink + batch_euclidean(pairs, pool).size();
+    });
+    runner.run("batch_extended_euclidean" + suffix, static_cast<double>(pairs.size()), [&pairs, &pool]()
+    {
+        g_sink = g_sink + batch_extended_euclidean(pairs, pool).size();
+    });
+
+    return correct;
+}
+
+// The text of the polynomials (see PolynomialText.hpp): the items are the bytes of the text
+template<typename T>
+void benchmark_text(BenchmarkRunner& runner)
+{
+    typedef Polynomial<T> P;
+    const size_t degree = 65536;
+    std::mt19937_64 rng(24680);
+    const P a = random_polynomial<T, DenseStorage<T> >(rng, degree, 1.0);
+
+    const polynomial_text_form forms[] = { text_printed, text_coefficients };
+    for (const polynomial_text_form form : forms)
+    {
+        const std::string suffix = std::string("/") + benchmark_coefficient<T>::name()
+            + (form == text_printed ? "/printed/" : "/coefficients/") + std::to_string(degree);
+
+        std::vector<char> buffer(64 * (degree + 1));
+        const std::to_chars_result text = format_polynomial(buffer.data(), buffer.data() + buffer.size(), a, form);
+        const double bytes = static_cast<double>(text.ptr - buffer.data());
+
+        runner.run("format" + suffix, bytes, [&a, &buffer, form]()
+        {
+            g_sink = g_sink + static_cast<size_t>(format_polynomial(buffer.data(), buffer.data() + buffer.size(), a, form).ptr - buffer.data());
+        });
+        runner.run("parse" + suffix, bytes, [&buffer, &text, form]()
+        {
+            P p;
+            parse_polynomial(buffer.data(), text.ptr, p, form);
+            g_sink = g_sink + p.degree();
+        });
+
+        if (form == text_printed)
+            runner.run("ostream" + suffix, bytes, [&a]() { std::ostringstream o; o << a; g_sink = g_sink + o.str().size(); });
+    }
+}
+
+// The arithmetic of the residue numbers, on arrays of them
+template<long M>
+void benchmark_residues(BenchmarkRunner& runner)
+{
+    typedef ResidueNum<M> R;
+    const size_t n = 4096;
+    const std::string suffix = std::string("/") + benchmark_coefficient<R>::name() + "/4096";
+
+    std::mt19937_64 rng(54321);
+    std::vector<R> a(n), b(n), c(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        a[i] = benchmark_coefficient<R>::random(rng);
+        do b[i] = benchmark_coefficient<R>::random(rng); while (b[i] == id_additive<R>::value);
+    }
+
+    runner.run("residue_add" + suffix, n, [&]() { for (size_t i = 0; i < n; ++i) c[i] = a[i] + b[i]; g_sink = g_sink + c[n - 1].number(); });
+    runner.run("residue_subtract" + suffix, n, [&]() { for (size_t i = 0; i < n; ++i) c[i] = a[i] - b[i]; g_sink = g_sink + c[n - 1].number(); });
+    runner.run("residue_multiply" + suffix, n, [&]() { for (size_t i = 0; i < n; ++i) c[i] = a[i] * b[i]; g_sink = g_sink + c[n - 1].number(); });
+    runner.run("residue_divide" + suffix, n, [&]() { for (size_t i = 0; i < n; ++i) c[i] = a[i] / b[i]; g_sink = g_sink + c[n - 1].number(); });
+}
+
+void write_json(const std::string& path, const std::vector<BenchmarkResult>& results)
+{
+    std::ofstream out(path);
+    out.precision(12);
+    out << "[\n";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const BenchmarkResult& result = results[i];
+        out << "  {\"name\": \"" << result.name << "\", \"iterations\": " << result.iterations
+            << ", \"ns_per_op\": " << result.ns_per_op << ", \"items_per_second\": " << result.items_per_second
+            << ", \"allocations_per_op\": " << result.allocations_per_op << ", \"bytes_per_op\": " << result.bytes_per_op
+            << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+// The ns/op of every result of a file written by write_json
+std::map<std::string, double> read_json(const std::string& path)
+{
+    std::map<std::string, double> baseline;
+    std::ifstream in(path);
+    if (!in)
+    {
+        std::cerr << "Cannot read the baseline " << path << std::endl;
+        std::exit(2);
+    }
+
+    const std::string name_key = "\"name\": \"";
+    const std::string time_key = "\"ns_per_op\": ";
+    std::string line;
+    while (std::getline(in, line))
+    {
+        const size_t name = line.find(name_key);
+        const size_t time = line.find(time_key);
+        if (name == std::string::npos || time == std::string::npos)
+            continue;
+
+        const size_t name_begin = name + name_key.size();
+        baseline[line.substr(name_begin, line.find('"', name_begin) - name_begin)] = std::atof(line.c_str() + time + time_key.size());
+    }
+
+    return baseline;
+}
+
+// Compare the results with the baseline, and return the number of regressions.
+size_t compare(const std::vector<BenchmarkResult>& results, const std::map<std::string, double>& baseline, const double threshold)
+{
+    size_t regressions = 0;
+    std::printf("\n%-44s %14s %14s %8s\n", "benchmark", "baseline ns", "current ns", "ratio");
+    for (const BenchmarkResult& result : results)
+    {
+        const std::map<std::string, double>::const_iterator base = baseline.find(result.name);
+        if (base == baseline.end() || base->second <= 0)
+            continue;
+
+        const double ratio = result.ns_per_op / base->second;
+        const bool regression = ratio > 1 + threshold;
+        regressions += regression;
+        std::printf("%-44s %14.0f %14.0f %8.3f%s\n", result.name.c_str(), base->second, result.ns_per_op, ratio,
+            regression ? "  REGRESSION" : (ratio < 1 - threshold ? "  improved" : ""));
+    }
+
+    std::printf("\n%zu regression(s) above %.0f%%\n", regressions, threshold * 100);
+    return regressions;
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--filter" && has_value)
+            options.filter = argv[++i];
+        else if (arg == "--min-time" && has_value)
+            options.min_time = std::atof(argv[++i]) / 1000;
+        else if (arg == "--json" && has_value)
+            options.json = argv[++i];
+        else if (arg == "--compare" && has_value)
+            options.compare = argv[++i];
+        else if (arg == "--threshold" && has_value)
+            options.threshold = std::atof(argv[++i]);
+        else
+        {
+            std::cerr << "Usage: " << argv[0]
+                << " [--filter text] [--min-time ms] [--json results.json] [--compare baseline.json] [--threshold 0.1]" << std::endl;
+            return 2;
+        }
+    }
+
+    BenchmarkRunner runner(options);
+
+    benchmark_type<long>(runner);
+    benchmark_type<double>(runner);
+    benchmark_type<Residue2>(runner);
+    benchmark_type<ResidueP>(runner);
+
+    // (The batches are checked before they are measured.)
+    const bool batches_correct = benchmark_batch<ResidueP>(runner);
+
+    benchmark_text<long>(runner);
+    benchmark_text<ResidueP>(runner);
+
+    benchmark_residues<2>(runner);
+    benchmark_residues<998244353>(runner);
+
+    if (!options.json.empty())
+        write_json(options.json, runner.results());
+
+    if (!batches_correct)
+        return 1;
+
+    if (!options.compare.empty())
+        return compare(runner.results(), read_json(options.compare), options.threshold) > 0 ? 1 : 0;
+
+    return 0;
+}
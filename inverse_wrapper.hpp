@@ -0,0 +1,97 @@
+#ifndef _INVERSE_WRAPPER_H
+#define _INVERSE_WRAPPER_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include "add_mult_identity.hpp"
+#include "Instrumentation.hpp"
+
+// Gets the multiplicative inverse for a given type, for the types where multiplying by the inverse
+// is an exact replacement of the division (like residue numbers, see Residue.hpp).
+
+// By default, we don't know the inverse for an arbitrary type: division has to use the / operator.
+// (For floating-point types, a * (1 / b) would round differently than a / b.)
+
+template<class _T>
+struct multiplicative_inverse
+{
+    static const bool known = false;
+};
+
+// A value to divide by many times: with a known inverse, its inverse is computed only once,
+// and every division is a multiplication.
+// (A value without an inverse, like a zero divisor of the residues modulo a composite number, is divided
+// by the / operator, which may still solve the divisions it is given.)
+template<class _T>
+class InverseCache
+{
+    public:
+        InverseCache(const _T& value) : m_value(value), m_invertible(false)
+        {
+            if constexpr (multiplicative_inverse<_T>::known)
+            {
+                try
+                {
+                    this->m_inverse = multiplicative_inverse<_T>::inverse(value);
+                    this->m_invertible = true;
+                }
+                catch (const std::invalid_argument&)
+                {
+                }
+            }
+        }
+
+        const _T& value() const { return this->m_value; }
+
+        // Whether the divisions are multiplications by the inverse
+        bool invertible() const { return this->m_invertible; }
+
+        // a / value
+        _T divide(const _T& a) const
+        {
+            if constexpr (multiplicative_inverse<_T>::known)
+            {
+                if (this->m_invertible)
+                    return a * this->m_inverse;
+            }
+
+            Instrumentation::inversions(1);
+            return a / this->m_value;
+        }
+
+    private:
+        _T m_value;
+        _T m_inverse;
+        bool m_invertible;
+};
+
+// Montgomery's trick: invert n values with a single inversion (and 3(n - 1) multiplications).
+// The inverse of the product of every value is taken, and the inverses of the values are peeled off it
+// by the prefix products. Every value has to be invertible.
+// (values and inverses may be the same buffer.)
+template<class _T>
+void batch_inverse(const _T* values, const size_t n, _T* inverses)
+{
+    if (n == 0)
+        return;
+
+    // prefix[i] = values[0] * ... * values[i]
+    std::vector<_T> prefix(n);
+    prefix[0] = values[0];
+    for (size_t i = 1; i < n; ++i)
+        prefix[i] = prefix[i - 1] * values[i];
+
+    // inverse = (values[0] * ... * values[i])^-1 at every step
+    _T inverse = InverseCache<_T>(prefix[n - 1]).divide(id_multiplicative<_T>::value);
+    for (size_t i = n - 1; i > 0; --i)
+    {
+        const _T value = values[i];
+        inverses[i] = inverse * prefix[i - 1];
+        inverse = inverse * value;
+    }
+
+    inverses[0] = inverse;
+}
+
+#endif // _INVERSE_WRAPPER_H
\ No newline at end of file
@@ -1,28 +1,67 @@
 #include <string>
 #include <iostream>
+#include <fstream>
 #include <limits>
+#include <map>
+#include <memory>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
 #include "Polynomial.hpp"
+#include "PolynomialText.hpp"
 #include "Residue.hpp"
+#include "GF2Polynomial.hpp"
 
 using namespace std;
 
 void banner();
+template<typename P>
+void extendedEuclidean(const P& g_x_o, const P& h_x_o, const P& zero, const P& one);
+int batch(istream& in, const bool trace);
+bool readPolynomial(const char* name, Polynomial<RuntimeResidueNum>& p);
+
+// Uso:
+//   main                            modo interactivo
+//   main --batch [archivo] [--trace] trabajos por lotes, de un archivo (o de la entrada estandar)
+int main(int argc, char* argv[]) {
+    bool batchMode = false, trace = false;
+    const char* path = nullptr;
+    for (int arg = 1; arg < argc; ++arg) {
+        if (strcmp(argv[arg], "--batch") == 0)
+            batchMode = true;
+        else if (strcmp(argv[arg], "--trace") == 0)
+            trace = true;
+        else if (batchMode && path == nullptr && argv[arg][0] != '-')
+            path = argv[arg];
+        else if (!(batchMode && strcmp(argv[arg], "-") == 0)) {
+            cerr << "Uso: " << argv[0] << " [--batch [archivo] [--trace]]" << endl;
+            return 2;
+        }
+    }
+
+    if (batchMode) {
+        ios::sync_with_stdio(false);
+        if (path == nullptr)
+            return batch(cin, trace);
+
+        ifstream file(path);
+        if (!file) {
+            cerr << "No se puede abrir " << path << endl;
+            return 2;
+        }
+        return batch(file, trace);
+    }
 
-int main() {
-    const long Z_n = 2;
-    int *ptr;
     long mod = 0;
-    size_t degree = 0;
-    long coefficient = 0;
-    bool fin = true;
-    char anotherTerm;
-    int i = 1;
 
     banner();
     cout << "Para el anillo Zn, indique el valor (entero positivo) de \"n\": ";
     cin >> (mod);
 
-    while (cin.fail()) {
+    while (cin.fail() || mod < 2 || mod > 0xFFFFFFFFL) {
+        if (cin.eof())
+            return 1;
+
         cout << "Para el anillo Zn, indique el valor (entero positivo) de \"n\": ";
         cin.clear();
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
@@ -30,122 +69,57 @@ int main() {
     }
     cout << endl;
 
-    ptr = (int*)( &Z_n );
-    *ptr = mod;
+    // Los coeficientes se calculan modulo n desde aqui
+    ResidueContext Z_n(mod);
+    ResidueContext::Scope Z_n_scope(Z_n);
 
     // Definir polinomios
-    Polynomial<ResidueNum<Z_n>> g_x, h_x, d_x, q_x, r_x, s_x, s1_x, s2_x, t_x, t1_x, t2_x, zero;
+    Polynomial<RuntimeResidueNum> g_x, h_x, zero, one;
 
     // g(x)
-    g_x.setMember(10, ResidueNum<Z_n>(1));  // x^10
-    g_x.setMember(9, ResidueNum<Z_n>(1));   // x^9
-    g_x.setMember(8, ResidueNum<Z_n>(1));   // x^8
-    g_x.setMember(6, ResidueNum<Z_n>(1));   // x^6
-    g_x.setMember(5, ResidueNum<Z_n>(1));   // x^5
-    g_x.setMember(4, ResidueNum<Z_n>(1));   // x^4
-    g_x.setMember(0, ResidueNum<Z_n>(1));   // 1
+    g_x.setMember(10, RuntimeResidueNum(1));  // x^10
+    g_x.setMember(9, RuntimeResidueNum(1));   // x^9
+    g_x.setMember(8, RuntimeResidueNum(1));   // x^8
+    g_x.setMember(6, RuntimeResidueNum(1));   // x^6
+    g_x.setMember(5, RuntimeResidueNum(1));   // x^5
+    g_x.setMember(4, RuntimeResidueNum(1));   // x^4
+    g_x.setMember(0, RuntimeResidueNum(1));   // 1
 
     // h(x)
-    h_x.setMember(9, ResidueNum<Z_n>(1));   // x^9
-    h_x.setMember(6, ResidueNum<Z_n>(1));   // x^6
-    h_x.setMember(5, ResidueNum<Z_n>(1));   // x^5
-    h_x.setMember(3, ResidueNum<Z_n>(1));   // x^3
-    h_x.setMember(2, ResidueNum<Z_n>(1));   // x^2
-    h_x.setMember(0, ResidueNum<Z_n>(1));   // 1
-
-//    // g(x)
-//    cout << "Polinomio g(x)" <<endl;
-//
-//    while(fin){
-//        cout << "Indique el grado del t\202rmino: ";
-//        cin >> degree;
-//
-//        while (cin.fail()) {
-//            cout << "Indique el grado del t\202rmino: ";
-//            cin.clear();
-//            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-//            cin >> degree;
-//        }
-//
-//        cout << "Indique el coeficiente del t\202rmino: ";
-//        cin >> coefficient;
-//
-//        while (cin.fail()) {
-//            cout << "Indique el coeficiente del t\202rmino: ";
-//            cin.clear();
-//            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-//            cin >> coefficient;
-//        }
-//
-//        g_x.setMember(degree, ResidueNum<Z_n>(coefficient));
-//
-//        cout << "¿Desea agregar otro t\202rmino al polinomio g(x)? [Y/N]: ";
-//        cin >> anotherTerm;
-//
-//        while (anotherTerm != 'Y' && anotherTerm != 'N') {
-//            cout << "¿Desea agregar otro t\202rmino al polinomio g(x)? [Y/N]: ";
-//            cin >> anotherTerm;
-//        }
-//
-//        if(anotherTerm == 'N') {
-//            fin = false;
-//        }
-//    }
-//    fin = true;
-//    cout << endl;
-//
-//    // h(x)
-//    cout << "Polinomio h(x)" <<endl;
-//    while(fin){
-//        cout << "Indique el grado del t\202rmino: ";
-//        cin >> degree;
-//
-//        while (cin.fail()) {
-//            cout << "Indique el grado del t\202rmino: ";
-//            cin.clear();
-//            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-//            cin >> degree;
-//        }
-//
-//        cout << "Indique el coeficiente del t\202rmino: ";
-//        cin >> coefficient;
-//
-//        while (cin.fail()) {
-//            cout << "Indique el coeficiente del t\202rmino: ";
-//            cin.clear();
-//            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-//            cin >> coefficient;
-//        }
-//
-//        h_x.setMember(degree, ResidueNum<Z_n>(coefficient));
-//
-//        cout << "¿Desea agregar otro t\202rmino al polinomio h(x)? [Y/N]: ";
-//        cin >> anotherTerm;
-//
-//        while (anotherTerm != 'Y' && anotherTerm != 'N') {
-//            cout << "¿Desea agregar otro t\202rmino al polinomio h(x)? [Y/N]: ";
-//            cin >> anotherTerm;
-//        }
-//
-//        if(anotherTerm == 'N') {
-//            fin = false;
-//        }
-//        cout << endl;
-//    }
-
-    d_x.setMember(0, ResidueNum<Z_n>(0));
-    q_x.setMember(0, ResidueNum<Z_n>(0));
-    r_x.setMember(0, ResidueNum<Z_n>(0));
-    s_x.setMember(0, ResidueNum<Z_n>(1));
-    s1_x.setMember(0, ResidueNum<Z_n>(1));
-    s2_x.setMember(0, ResidueNum<Z_n>(0));
-    t_x.setMember(0, ResidueNum<Z_n>(0));
-    t1_x.setMember(0, ResidueNum<Z_n>(0));
-    t2_x.setMember(0, ResidueNum<Z_n>(1));
-    zero.setMember(0, ResidueNum<Z_n>(0));
-
-    Polynomial<ResidueNum<Z_n>>g_x_o = g_x;
-    Polynomial<ResidueNum<Z_n>>h_x_o = h_x;
+    h_x.setMember(9, RuntimeResidueNum(1));   // x^9
+    h_x.setMember(6, RuntimeResidueNum(1));   // x^6
+    h_x.setMember(5, RuntimeResidueNum(1));   // x^5
+    h_x.setMember(3, RuntimeResidueNum(1));   // x^3
+    h_x.setMember(2, RuntimeResidueNum(1));   // x^2
+    h_x.setMember(0, RuntimeResidueNum(1));   // 1
+
+    // Los polinomios se pueden dar en la forma impresa; si no, se toman los de ejemplo
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    readPolynomial("g(x)", g_x);
+    readPolynomial("h(x)", h_x);
+    cout << endl;
+
+    zero.setMember(0, RuntimeResidueNum(0));
+    one.setMember(0, RuntimeResidueNum(1));
+
+    // En Z_2 los polinomios se guardan empaquetados en bits
+    if (mod == 2)
+        extendedEuclidean(GF2Polynomial(g_x), GF2Polynomial(h_x), GF2Polynomial(false), GF2Polynomial(true));
+    else
+        extendedEuclidean(g_x, h_x, zero, one);
+
+    return 0;
+}
+
+template<typename P>
+void extendedEuclidean(const P& g_x_o, const P& h_x_o, const P& zero, const P& one) {
+    int i = 1;
+#ifdef POLYNOMIAL_INSTRUMENTATION
+    const InstrumentationStats before = Instrumentation::snapshot();
+#endif
+
+    // Definir polinomios
+    P g_x = g_x_o, h_x = h_x_o, d_x = zero, q_x = zero, r_x = zero, s_x = one, s1_x = one, s2_x = zero, t_x = zero, t1_x = zero, t2_x = one;
 
     if (h_x == zero) {
         d_x = g_x_o;
@@ -162,10 +136,16 @@ int main() {
 
         try
         {
-            q_x = (g_x / h_x);
-            r_x = (g_x % h_x);
-            s_x = s2_x - q_x * s1_x;
-            t_x = t2_x - q_x * t1_x;
+            Instrumentation::iteration(h_x);
+            {
+                Instrumentation::PhaseTimer timer(phase_division);
+                divmod(g_x, h_x, q_x, r_x);
+            }
+            {
+                Instrumentation::PhaseTimer timer(phase_cofactors);
+                s_x = s2_x; submul(s_x, q_x, s1_x);
+                t_x = t2_x; submul(t_x, q_x, t1_x);
+            }
 
             cout << "s2(x)= " << s2_x << endl;
             cout << "s1(x)= " << s1_x << endl;
@@ -176,16 +156,18 @@ int main() {
             cout << "s(x)= " << s_x << endl;
             cout << "t(x)= " << t_x << endl;
 
-            g_x = h_x;
-            h_x = r_x;
-            s2_x = s1_x;
-            s1_x = s_x;
-            t2_x = t1_x;
-            t1_x = t_x;
+            g_x = std::move(h_x);
+            h_x = std::move(r_x);
+            s2_x = std::move(s1_x);
+            s1_x = std::move(s_x);
+            t2_x = std::move(t1_x);
+            t1_x = std::move(t_x);
         }
         catch (const exception& e)
         {
+            // El estado no cambia, asi que no se puede seguir (por ejemplo, un coeficiente sin inverso modulo n)
             cout << "ERROR: " << endl << e.what() << endl;
+            return;
         }
         cout << endl;
         i+=1;
@@ -198,7 +180,10 @@ int main() {
     cout << "s(x)= " << s2_x << endl;
     cout << "t(x)= " << t2_x << endl;
 
-    return 0;
+#ifdef POLYNOMIAL_INSTRUMENTATION
+    cout << endl << "_-_-_-_-_-_-_-_-_-_-_-_ ESTADISTICAS _-_-_-_-_-_-_-_-_-_-_-_" << endl << endl;
+    cout << Instrumentation::stats().since(before);
+#endif
 }
 
 void banner(){
@@ -216,3 +201,194 @@ void banner(){
     cout << "ALGORITMO EXTENDIDO DE EUCLIDES PARA POLINOMIOS" << endl << endl;
     cout << "JOAQUIN INOROSA FIGUEROA" << endl << endl;
 }
+
+// Lee un polinomio en la forma impresa (por ejemplo "x^2 + 3x + 1"), repitiendo la pregunta si no es valido.
+// Con una linea vacia (o al final de la entrada) el polinomio no cambia y se devuelve false.
+bool readPolynomial(const char* name, Polynomial<RuntimeResidueNum>& p) {
+    string line;
+    while (true) {
+        cout << "Polinomio " << name << " (vacio para el de ejemplo): ";
+        if (!getline(cin, line))
+            return false;
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.find_first_not_of(" \t") == string::npos)
+            return false;
+
+        Polynomial<RuntimeResidueNum> read;
+        const from_chars_result parsed = parse_polynomial(line.data(), line.data() + line.size(), read);
+        if (parsed.ec == errc() && parsed.ptr == line.data() + line.size()) {
+            p = std::move(read);
+            return true;
+        }
+
+        cout << "El polinomio no es valido (en la columna " << (parsed.ptr - line.data() + 1) << ")." << endl;
+    }
+}
+
+// Modo por lotes: un trabajo por linea, "n; g; h", donde g y h son los coeficientes de los polinomios
+// desde la mayor potencia, separados por espacios (por ejemplo "7; 1 0 3; 2 1" es g(x) = x^2 + 3, h(x) = 2x + 1),
+// o los polinomios en la forma impresa ("7; x^2 + 3; 2x + 1").
+// Las lineas vacias y las que empiezan por '#' se saltan.
+//
+// Por cada trabajo se escribe una linea "d; s; t" (en el mismo formato, "0" para el polinomio nulo),
+// con d(x) = s(x)g(x) + t(x)h(x), o "error; <linea>; <mensaje>" si el trabajo no es valido.
+// Con --trace, cada iteracion se escribe antes como "trace; <i>; q; r; s; t".
+//
+// Los trabajos se procesan de uno en uno y la salida se acumula en un buffer que se escribe por bloques,
+// asi que la memoria no crece con el numero de trabajos.
+
+namespace {
+    const size_t batchFlushSize = 1 << 16;
+    const size_t batchContexts = 16;
+
+    // Salida acumulada, escrita en bloques de batchFlushSize
+    void flushOutput(string& out, const bool force) {
+        if (out.size() >= batchFlushSize || (force && !out.empty())) {
+            cout.write(out.data(), static_cast<streamsize>(out.size()));
+            out.clear();
+        }
+    }
+
+    void appendNumber(string& out, const long number) {
+        char digits[24];
+        const to_chars_result written = to_chars(digits, digits + sizeof(digits), number);
+        out.append(digits, written.ptr);
+    }
+
+    // Escribe los coeficientes del polinomio (desde la mayor potencia) al final de la salida
+    template<typename P>
+    void appendPolynomial(string& out, const P& p) {
+        const size_t used = out.size();
+        for (size_t room = 16 + 12 * (p.degree() + 1); ; room *= 2) {
+            out.resize(used + room);
+            const to_chars_result written = format_polynomial(&out[used], &out[0] + out.size(), p, text_coefficients);
+            if (written.ec == errc()) {
+                out.resize(static_cast<size_t>(written.ptr - out.data()));
+                return;
+            }
+        }
+    }
+
+    // Lee un campo con los coeficientes (desde la mayor potencia) o con el polinomio en la forma impresa
+    bool parsePolynomial(const char* begin, const char* end, Polynomial<RuntimeResidueNum>& p) {
+        const from_chars_result read = parse_polynomial(begin, end, p, text_coefficients);
+        if (read.ec == errc() && read.ptr == end)
+            return true;
+
+        const from_chars_result printed = parse_polynomial(begin, end, p, text_printed);
+        return printed.ec == errc() && printed.ptr == end;
+    }
+
+    // El algoritmo extendido de un trabajo
+    template<typename P>
+    void batchJob(const P& g_x, const P& h_x, const bool trace, string& out) {
+        if (!trace) {
+            // (Como en el modo interactivo, gcd(g, 0) = g = 1 * g + 0 * h.)
+            const EEuclideanResult<P> result = extended_euclidean(g_x, h_x);
+
+            appendPolynomial(out, result.gcd); out += "; ";
+            appendPolynomial(out, result.x); out += "; ";
+            appendPolynomial(out, result.y); out += '\n';
+            return;
+        }
+
+        // Las mismas iteraciones que el modo interactivo
+        P g = g_x, h = h_x, q, r, s, t;
+        P s2 = id_multiplicative<P>::value, s1 = id_additive<P>::value;
+        P t2 = id_additive<P>::value, t1 = id_multiplicative<P>::value;
+        for (long i = 1; !h.isNull(); ++i) {
+            divmod(g, h, q, r);
+            s = s2; submul(s, q, s1);
+            t = t2; submul(t, q, t1);
+
+            out += "trace; "; appendNumber(out, i); out += "; ";
+            appendPolynomial(out, q); out += "; ";
+            appendPolynomial(out, r); out += "; ";
+            appendPolynomial(out, s); out += "; ";
+            appendPolynomial(out, t); out += '\n';
+            flushOutput(out, false);
+
+            g = std::move(h);
+            h = std::move(r);
+            s2 = std::move(s1);
+            s1 = std::move(s);
+            t2 = std::move(t1);
+            t1 = std::move(t);
+        }
+
+        appendPolynomial(out, g); out += "; ";
+        appendPolynomial(out, s2); out += "; ";
+        appendPolynomial(out, t2); out += '\n';
+    }
+}
+
+int batch(istream& in, const bool trace) {
+    string line, out;
+    out.reserve(2 * batchFlushSize);
+
+    // Los contextos de los ultimos modulos se reutilizan (como mucho batchContexts a la vez)
+    map<long, unique_ptr<ResidueContext> > contexts;
+    int status = 0;
+
+    for (size_t number = 1; getline(in, line); ++number) {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+
+        const size_t start = line.find_first_not_of(" \t");
+        if (start == string::npos || line[start] == '#')
+            continue;
+
+        try
+        {
+            const char* begin = line.data() + start;
+            const char* end = line.data() + line.size();
+            const char* first = find(begin, end, ';');
+            const char* second = (first == end ? end : find(first + 1, end, ';'));
+            if (second == end)
+                throw invalid_argument("se esperaba \"n; g; h\"");
+
+            while (*begin == ' ' || *begin == '\t')
+                ++begin;
+
+            long mod = 0;
+            const from_chars_result read = from_chars(begin, first, mod);
+            if (read.ec != errc() || read.ptr == begin)
+                throw invalid_argument("modulo no valido");
+            for (const char* rest = read.ptr; rest != first; ++rest) {
+                if (*rest != ' ' && *rest != '\t')
+                    throw invalid_argument("modulo no valido");
+            }
+
+            map<long, unique_ptr<ResidueContext> >::iterator context = contexts.find(mod);
+            if (context == contexts.end()) {
+                if (contexts.size() >= batchContexts)
+                    contexts.clear();
+                context = contexts.emplace(mod, unique_ptr<ResidueContext>(new ResidueContext(mod))).first;
+            }
+            ResidueContext::Scope scope(*context->second);
+
+            Polynomial<RuntimeResidueNum> g_x, h_x;
+            if (!parsePolynomial(first + 1, second, g_x) || !parsePolynomial(second + 1, end, h_x))
+                throw invalid_argument("coeficientes no validos");
+
+            // En Z_2 los polinomios se guardan empaquetados en bits
+            if (mod == 2)
+                batchJob(GF2Polynomial(g_x), GF2Polynomial(h_x), trace, out);
+            else
+                batchJob(g_x, h_x, trace, out);
+        }
+        catch (const exception& e)
+        {
+            out += "error; "; appendNumber(out, static_cast<long>(number)); out += "; ";
+            out += e.what(); out += '\n';
+            status = 1;
+        }
+
+        flushOutput(out, false);
+    }
+
+    flushOutput(out, true);
+    cout.flush();
+    return status;
+}